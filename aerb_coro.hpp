@@ -0,0 +1,244 @@
+#ifndef AERB_CORO_HPP
+#define AERB_CORO_HPP
+
+// --- RING CON CORRUTINAS (C++20) ---
+// aerb::AsyncRing<T, Capacity>: un aerb::Ring MPMC con awaitables
+//     T ev = co_await ring.pop();
+//     co_await ring.push(std::move(ev));
+// que suspenden la corrutina si el ring está vacío/lleno en vez de sondear. Cada
+// awaiter suspendido es un nodo dentro del propio frame de la corrutina, encolado en
+// una lista lock-free (pila de Treiber) por lado: esperar no reserva memoria ni hilo,
+// así que miles de consumidores pueden compartir unos pocos hilos del executor.
+//
+// Quien hace avanzar el ring (push/pop con éxito) despierta al lado contrario: saca
+// nodos, completa la operación en su nombre (el evento ya va dentro del awaiter al
+// reanudarlo) y, tras soltar la lista, los reanuda. Si no puede completarla, devuelve
+// el nodo a la lista.
+//
+// Sin lost wakeups: quien publica hace fence seq_cst y luego mira la lista; quien se
+// encola hace fence seq_cst y luego mira el ring (Dekker). Uno de los dos ve al otro.
+// Solo un hilo a la vez saca nodos de cada lista (el resto deja 'pending' y se va),
+// así que la pila no sufre ABA y el despertar tampoco bloquea.
+//
+// Las corrutinas se reanudan con el 'Scheduler' del constructor (p. ej. encolarlas en
+// el executor) o, sin él, en línea en el hilo que las despierta.
+// No destruir el ring con corrutinas suspendidas en él.
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "aerb_ring.hpp"
+
+namespace aerb {
+
+using Scheduler = void (*)(std::coroutine_handle<> handle, void *ctx);
+
+template <class T, std::size_t Capacity>
+class AsyncRing {
+    static_assert(std::is_default_constructible_v<T>, "aerb::AsyncRing: pop() necesita T por defecto");
+
+    struct Waiter {
+        Waiter *next;
+        std::coroutine_handle<> handle;
+    };
+
+    struct alignas(cache_line_size) WaitList {
+        std::atomic<Waiter *> head{nullptr};
+        std::atomic<bool> busy{false};          // Hay un hilo sacando nodos
+        std::atomic<std::uint32_t> pending{0};  // Avisos llegados mientras tanto
+    };
+
+public:
+    class PopAwaiter : Waiter {
+        friend class AsyncRing;
+        AsyncRing &ring_;
+        T value_{};
+
+    public:
+        explicit PopAwaiter(AsyncRing &ring) noexcept : ring_(ring) {}
+
+        bool await_ready() { return ring_.try_pop(value_); }
+
+        // No toca 'this' después de wake(): puede habernos reanudado ya (y destruido el frame).
+        void await_suspend(std::coroutine_handle<> h) {
+            this->handle = h;
+            ring_.consumers_wait(this);
+        }
+
+        T await_resume() noexcept(std::is_nothrow_move_constructible_v<T>) { return std::move(value_); }
+    };
+
+    class PushAwaiter : Waiter {
+        friend class AsyncRing;
+        AsyncRing &ring_;
+        T value_;
+
+    public:
+        PushAwaiter(AsyncRing &ring, T &&value) noexcept(std::is_nothrow_move_constructible_v<T>)
+            : ring_(ring), value_(std::move(value)) {}
+
+        bool await_ready() { return ring_.try_push(std::move(value_)); }
+
+        void await_suspend(std::coroutine_handle<> h) {
+            this->handle = h;
+            ring_.producers_wait(this);
+        }
+
+        void await_resume() noexcept {}
+    };
+
+    explicit AsyncRing(Scheduler scheduler = nullptr, void *ctx = nullptr) noexcept
+        : scheduler_(scheduler), ctx_(ctx) {}
+
+    AsyncRing(const AsyncRing &) = delete;
+    AsyncRing &operator=(const AsyncRing &) = delete;
+
+    [[nodiscard]] PopAwaiter pop() noexcept { return PopAwaiter(*this); }
+    [[nodiscard]] PushAwaiter push(T value) { return PushAwaiter(*this, std::move(value)); }
+
+    // Versiones sin suspender; también despiertan al lado contrario.
+    bool try_push(T &&value) {
+        if (!ring_.try_push(std::move(value))) {
+            return false;
+        }
+        wake(consumers_, &AsyncRing::complete_pop);
+        return true;
+    }
+
+    bool try_pop(T &out) {
+        if (!ring_.try_pop(out)) {
+            return false;
+        }
+        wake(producers_, &AsyncRing::complete_push);
+        return true;
+    }
+
+    std::uint64_t size() const noexcept { return ring_.size(); }
+
+private:
+    using Complete = bool (AsyncRing::*)(Waiter *);
+
+    bool complete_pop(Waiter *w) {
+        return ring_.try_pop(static_cast<PopAwaiter *>(w)->value_);
+    }
+
+    bool complete_push(Waiter *w) {
+        return ring_.try_push(std::move(static_cast<PushAwaiter *>(w)->value_));
+    }
+
+    bool can_pop() const noexcept { return !ring_.empty(); }
+    bool can_push() const noexcept { return !ring_.full(); }
+
+    void consumers_wait(Waiter *w) {
+        enqueue(consumers_, w);
+        wake(consumers_, &AsyncRing::complete_pop);
+    }
+
+    void producers_wait(Waiter *w) {
+        enqueue(producers_, w);
+        wake(producers_, &AsyncRing::complete_push);
+    }
+
+    static void enqueue(WaitList &list, Waiter *w) noexcept {
+        Waiter *head = list.head.load(std::memory_order_relaxed);
+        do {
+            w->next = head;
+        } while (!list.head.compare_exchange_weak(head, w, std::memory_order_release,
+                                                  std::memory_order_relaxed));
+    }
+
+    void resume(Waiter *w) {
+        std::coroutine_handle<> handle = w->handle;
+        if (scheduler_ != nullptr) {
+            scheduler_(handle, ctx_);
+        } else {
+            handle.resume();
+        }
+    }
+
+    // Nodos ya completados que faltan por reanudar, en el orden en que se completaron.
+    struct ReadyList {
+        Waiter *head = nullptr;
+        Waiter *tail = nullptr;
+    };
+
+    // Reparte lo que haya en el ring entre los nodos de 'list' hasta que uno de los dos
+    // se agote. Si otro hilo ya está repartiendo, solo le deja el aviso. Las corrutinas
+    // completadas se reanudan después de soltar 'busy': una que siga en línea (y vuelva
+    // a esperar en este ring, o tarde en suspenderse) no retiene el reparto de la lista.
+    void wake(WaitList &list, Complete complete) {
+        std::atomic_thread_fence(std::memory_order_seq_cst); // Publicación antes que la lista
+        if (list.head.load(std::memory_order_relaxed) == nullptr) {
+            return; // Camino rápido: nadie espera
+        }
+        list.pending.fetch_add(1, std::memory_order_seq_cst);
+        for (;;) {
+            if (list.busy.exchange(true, std::memory_order_acquire)) {
+                return; // El dueño actual verá 'pending'
+            }
+            list.pending.exchange(0, std::memory_order_acq_rel);
+            ReadyList ready;
+            drain(list, complete, ready);
+            list.busy.store(false, std::memory_order_seq_cst);
+            if (ready.head != nullptr) {
+                // Completar libera/ocupa ranuras: puede haber alguien esperando enfrente.
+                if (&list == &consumers_) {
+                    wake(producers_, &AsyncRing::complete_push);
+                } else {
+                    wake(consumers_, &AsyncRing::complete_pop);
+                }
+                for (Waiter *w = ready.head; w != nullptr;) {
+                    Waiter *next = w->next; // Reanudar puede destruir el frame que contiene 'w'
+                    resume(w);
+                    w = next;
+                }
+            }
+            if (list.pending.load(std::memory_order_seq_cst) == 0) {
+                return;
+            }
+        }
+    }
+
+    void drain(WaitList &list, Complete complete, ReadyList &ready) {
+        for (;;) {
+            // Único hilo que saca: 'next' del nodo cabeza no puede cambiar (sin ABA).
+            Waiter *w = list.head.load(std::memory_order_acquire);
+            while (w != nullptr && !list.head.compare_exchange_weak(w, w->next, std::memory_order_acquire,
+                                                                    std::memory_order_acquire)) {
+            }
+            if (w == nullptr) {
+                return;
+            }
+            if ((this->*complete)(w)) {
+                w->next = nullptr;
+                if (ready.tail != nullptr) {
+                    ready.tail->next = w;
+                } else {
+                    ready.head = w;
+                }
+                ready.tail = w;
+                continue;
+            }
+            enqueue(list, w);
+            // Lista antes que el ring: si ahora hay algo, quien lo publicó pudo no vernos.
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (&list == &consumers_ ? !can_pop() : !can_push()) {
+                return;
+            }
+        }
+    }
+
+    Ring<T, Capacity, mpmc> ring_;
+    Scheduler scheduler_;
+    void *ctx_;
+    WaitList consumers_;
+    WaitList producers_;
+};
+
+} // namespace aerb
+
+#endif // AERB_CORO_HPP
@@ -0,0 +1,405 @@
+#ifndef AERB_RING_HPP
+#define AERB_RING_HPP
+
+// --- RING PARA C++ ---
+// aerb::Ring<T, Capacity, Policy>: el protocolo por ranura de AtomicEventRingBuffer como
+// plantilla de C++17, para cualquier T (también solo-movible). La capacidad y la política
+// se fijan en compilación, así que la máscara es constante y los atómicos que la política
+// no necesita no existen:
+//   aerb::spsc  - sin sellos por ranura; cada lado cachea la posición del otro.
+//   aerb::mpsc  - sellos por ranura, CAS solo entre productores; 'head' es un entero normal.
+//   aerb::mpmc  - sellos por ranura, CAS en ambos lados.
+// Los elementos se construyen en la ranura (placement new) al reclamarla y se mueven
+// fuera al extraerlos: ni try_push(T&&) ni emplace copian, y si el ring está lleno el
+// argumento no se toca (salvo la carrera que explica emplace, con mpsc/mpmc y un
+// constructor que puede lanzar).
+// No incluye atomic_event_ring_buffer.h: <stdatomic.h> no se puede usar desde C++17.
+// Comparte sus constantes de layout (línea de caché, firma del segmento compartido).
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace aerb {
+
+inline constexpr std::size_t cache_line_size = 64; // CACHE_LINE_SIZE del core en C
+inline constexpr std::uint32_t shared_magic = 0x41455242u; // "AERB", como RING_LAYOUT_MAGIC
+
+// --- POLÍTICAS ---
+struct spsc {
+    static constexpr bool multi_producer = false;
+    static constexpr bool multi_consumer = false;
+};
+struct mpsc {
+    static constexpr bool multi_producer = true;
+    static constexpr bool multi_consumer = false;
+};
+struct mpmc {
+    static constexpr bool multi_producer = true;
+    static constexpr bool multi_consumer = true;
+};
+
+inline void cpu_relax() noexcept {
+#ifdef __x86_64__
+    __builtin_ia32_pause();
+#endif
+}
+
+namespace detail {
+
+// Ranura con sello (Vyukov): pos libre, pos + 1 publicada, pos + Capacity liberada.
+template <class T>
+struct SequencedSlot {
+    std::atomic<std::uint64_t> sequence;
+    alignas(T) unsigned char storage[sizeof(T)];
+};
+
+// Ranura del SPSC: la publicación es el store-release de 'tail'.
+template <class T>
+struct PlainSlot {
+    alignas(T) unsigned char storage[sizeof(T)];
+};
+
+// Cabecera del segmento compartido, antes del ring (alineado a línea de caché).
+struct SharedHeader {
+    std::atomic<std::uint32_t> magic; // Se escribe la última
+    std::uint32_t element_size;
+    std::uint64_t ring_size;
+    std::uint64_t capacity;
+};
+
+} // namespace detail
+
+template <class T, std::size_t Capacity, class Policy = mpmc>
+class Ring {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "aerb::Ring: Capacity debe ser potencia de dos >= 2");
+    static_assert(std::is_nothrow_destructible_v<T>, "aerb::Ring: T no puede lanzar al destruirse");
+
+    static constexpr bool sequenced = Policy::multi_producer || Policy::multi_consumer;
+    // Con sellos, una ranura reclamada tiene que publicarse (o liberarse) siempre: si no,
+    // todos los que lleguen después esperan a su sello para siempre. Mover T no puede
+    // lanzar; construirlo sí (emplace lo construye antes de reclamar).
+    static_assert(!sequenced || (std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>),
+                  "aerb::Ring: con mpsc/mpmc, mover T no puede lanzar");
+    static constexpr std::uint64_t mask = Capacity - 1;
+
+    using Slot = std::conditional_t<sequenced, detail::SequencedSlot<T>, detail::PlainSlot<T>>;
+    // Posición de un lado: atómica si varios hilos la reclaman o si el otro lado la lee.
+    using ConsumerPos = std::conditional_t<Policy::multi_consumer || !sequenced,
+                                           std::atomic<std::uint64_t>, std::uint64_t>;
+
+public:
+    using value_type = T;
+    static constexpr std::size_t capacity = Capacity;
+
+    Ring() noexcept {
+        store_pos(head_, 0);
+        tail_.store(0, std::memory_order_relaxed);
+        if constexpr (sequenced) {
+            for (std::uint64_t i = 0; i < Capacity; i++) {
+                slots_[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    // Destruye los elementos que queden. Sin hilos usando el ring.
+    ~Ring() {
+        std::uint64_t head = load_pos(head_);
+        std::uint64_t tail = tail_.load(std::memory_order_relaxed);
+        for (std::uint64_t pos = head; pos != tail; pos++) {
+            Slot &slot = slots_[pos & mask];
+            if constexpr (sequenced) {
+                if (slot.sequence.load(std::memory_order_relaxed) != pos + 1) {
+                    continue; // Reclamada y nunca publicada
+                }
+            }
+            element(slot)->~T();
+        }
+    }
+
+    Ring(const Ring &) = delete;
+    Ring &operator=(const Ring &) = delete;
+
+    // --- PRODUCTOR ---
+    // Construye el elemento en la ranura. Retorna false (sin construir nada) si está lleno.
+    // Con sellos y un constructor que puede lanzar, el elemento se construye antes de
+    // reclamar y se mueve a la ranura: si lanza, no queda nada reclamado. Antes se mira si
+    // hay sitio, así que un ring lleno no toca los 'args'; solo si otro productor se lleva
+    // la última ranura entre esa mirada y la reclamación se retorna false con unos 'args'
+    // por valor-r ya movidos.
+    template <class... Args>
+    bool emplace(Args &&...args) noexcept(std::is_nothrow_constructible_v<T, Args...>) {
+        if constexpr (!sequenced) {
+            std::uint64_t tail = tail_.load(std::memory_order_relaxed);
+            if (tail - cached_head_ == Capacity) {
+                cached_head_ = head_.load(std::memory_order_acquire);
+                if (tail - cached_head_ == Capacity) {
+                    cpu_relax();
+                    return false;
+                }
+            }
+            ::new (static_cast<void *>(slots_[tail & mask].storage)) T(std::forward<Args>(args)...);
+            tail_.store(tail + 1, std::memory_order_release);
+            return true;
+        } else if constexpr (std::is_nothrow_constructible_v<T, Args...>) {
+            std::uint64_t pos;
+            Slot *slot = claim(tail_, 0, pos);
+            if (slot == nullptr) {
+                return false;
+            }
+            ::new (static_cast<void *>(slot->storage)) T(std::forward<Args>(args)...);
+            slot->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        } else {
+            if (full()) {
+                cpu_relax();
+                return false;
+            }
+            T value(std::forward<Args>(args)...);
+            std::uint64_t pos;
+            Slot *slot = claim(tail_, 0, pos);
+            if (slot == nullptr) {
+                return false;
+            }
+            ::new (static_cast<void *>(slot->storage)) T(std::move(value));
+            slot->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+    }
+
+    bool try_push(T &&value) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        return emplace(std::move(value));
+    }
+
+    bool try_push(const T &value) noexcept(std::is_nothrow_copy_constructible_v<T>) {
+        return emplace(value);
+    }
+
+    // --- CONSUMIDOR ---
+    // Mueve el siguiente elemento a 'out' y lo destruye en la ranura. false si está vacío.
+    bool try_pop(T &out) noexcept(std::is_nothrow_move_assignable_v<T>) {
+        if constexpr (!sequenced) {
+            std::uint64_t head = head_.load(std::memory_order_relaxed);
+            if (head == cached_tail_) {
+                cached_tail_ = tail_.load(std::memory_order_acquire);
+                if (head == cached_tail_) {
+                    cpu_relax();
+                    return false;
+                }
+            }
+            take(slots_[head & mask], out);
+            head_.store(head + 1, std::memory_order_release);
+            return true;
+        } else if constexpr (!Policy::multi_consumer) {
+            // Único consumidor: basta con que la ranura esté publicada, sin CAS.
+            std::uint64_t pos = head_;
+            Slot &slot = slots_[pos & mask];
+            if (slot.sequence.load(std::memory_order_acquire) != pos + 1) {
+                cpu_relax();
+                return false;
+            }
+            take(slot, out);
+            slot.sequence.store(pos + Capacity, std::memory_order_release);
+            head_ = pos + 1;
+            return true;
+        } else {
+            std::uint64_t pos;
+            Slot *slot = claim(head_, 1, pos);
+            if (slot == nullptr) {
+                return false;
+            }
+            take(*slot, out);
+            slot->sequence.store(pos + Capacity, std::memory_order_release);
+            return true;
+        }
+    }
+
+    // Ocupación aproximada (exacta sin hilos concurrentes).
+    std::uint64_t size() const noexcept {
+        std::uint64_t head = load_pos(head_);
+        std::uint64_t tail = tail_.load(std::memory_order_acquire);
+        std::uint64_t n = tail - head;
+        return n > Capacity ? Capacity : n;
+    }
+
+    // ¿Fallaría ahora try_pop / try_push? Miran la ranura siguiente como lo haría la
+    // operación: una ranura reclamada y aún no publicada cuenta como vacía/llena.
+    // Con mpsc, empty() solo desde el consumidor.
+    bool empty() const noexcept {
+        std::uint64_t head = load_pos(head_);
+        if constexpr (!sequenced) {
+            return head == tail_.load(std::memory_order_acquire);
+        } else {
+            return slots_[head & mask].sequence.load(std::memory_order_acquire) != head + 1;
+        }
+    }
+
+    bool full() const noexcept {
+        std::uint64_t tail = tail_.load(std::memory_order_acquire);
+        if constexpr (!sequenced) {
+            return tail - head_.load(std::memory_order_acquire) == Capacity;
+        } else {
+            return slots_[tail & mask].sequence.load(std::memory_order_acquire) != tail;
+        }
+    }
+
+    // --- MEMORIA COMPARTIDA ---
+    // Crea el objeto POSIX shm 'name' (no debe existir) con el ring dentro, o lo mapea
+    // desde otro proceso. Solo para T trivialmente copiable: sus bytes deben tener
+    // sentido en cualquier proceso y el ring nunca se destruye desde allí.
+    // Retornan nullptr con errno (EINVAL si el layout no coincide, EAGAIN si el
+    // creador aún no terminó). Se desmapean con unmap_shared; shm_unlink borra el nombre.
+    static Ring *create_shared(const char *name) {
+        static_assert(std::is_trivially_copyable_v<T>,
+                      "aerb::Ring: en memoria compartida T debe ser trivialmente copiable");
+        static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+                      "aerb::Ring: los atómicos compartidos deben ser lock-free");
+        int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) {
+            return nullptr;
+        }
+        if (ftruncate(fd, static_cast<off_t>(shared_bytes())) != 0) {
+            int saved = errno;
+            close(fd);
+            shm_unlink(name);
+            errno = saved;
+            return nullptr;
+        }
+        void *base = mmap(nullptr, shared_bytes(), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        int saved = errno;
+        close(fd);
+        if (base == MAP_FAILED) {
+            shm_unlink(name);
+            errno = saved;
+            return nullptr;
+        }
+        auto *header = ::new (base) detail::SharedHeader{};
+        header->element_size = sizeof(T);
+        header->ring_size = sizeof(Ring);
+        header->capacity = Capacity;
+        Ring *ring = ::new (ring_of(base)) Ring();
+        header->magic.store(shared_magic, std::memory_order_release);
+        return ring;
+    }
+
+    static Ring *attach_shared(const char *name) {
+        static_assert(std::is_trivially_copyable_v<T>,
+                      "aerb::Ring: en memoria compartida T debe ser trivialmente copiable");
+        int fd = shm_open(name, O_RDWR, 0);
+        if (fd < 0) {
+            return nullptr;
+        }
+        struct stat st = {};
+        if (fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) != shared_bytes()) {
+            int err = st.st_size == 0 ? EAGAIN : EINVAL;
+            close(fd);
+            errno = err;
+            return nullptr;
+        }
+        void *base = mmap(nullptr, shared_bytes(), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        int saved = errno;
+        close(fd);
+        if (base == MAP_FAILED) {
+            errno = saved;
+            return nullptr;
+        }
+        auto *header = static_cast<detail::SharedHeader *>(base);
+        std::uint32_t magic = header->magic.load(std::memory_order_acquire);
+        int err = 0;
+        if (magic == 0) {
+            err = EAGAIN;
+        } else if (magic != shared_magic || header->element_size != sizeof(T) ||
+                   header->ring_size != sizeof(Ring) || header->capacity != Capacity) {
+            err = EINVAL;
+        }
+        if (err != 0) {
+            munmap(base, shared_bytes());
+            errno = err;
+            return nullptr;
+        }
+        return std::launder(static_cast<Ring *>(ring_of(base)));
+    }
+
+    static void unmap_shared(Ring *ring) noexcept {
+        munmap(reinterpret_cast<unsigned char *>(ring) - ring_offset(), shared_bytes());
+    }
+
+private:
+    static constexpr std::size_t ring_offset() noexcept {
+        return (sizeof(detail::SharedHeader) + alignof(Ring) - 1) & ~(alignof(Ring) - 1);
+    }
+
+    static std::size_t shared_bytes() noexcept {
+        std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        return (ring_offset() + sizeof(Ring) + page - 1) & ~(page - 1);
+    }
+
+    static void *ring_of(void *base) noexcept {
+        return static_cast<unsigned char *>(base) + ring_offset();
+    }
+
+    static T *element(Slot &slot) noexcept {
+        return std::launder(reinterpret_cast<T *>(slot.storage));
+    }
+
+    static void take(Slot &slot, T &out) noexcept(std::is_nothrow_move_assignable_v<T>) {
+        T *value = element(slot);
+        out = std::move(*value);
+        value->~T();
+    }
+
+    static void store_pos(std::atomic<std::uint64_t> &pos, std::uint64_t v) noexcept {
+        pos.store(v, std::memory_order_relaxed);
+    }
+    static void store_pos(std::uint64_t &pos, std::uint64_t v) noexcept { pos = v; }
+    static std::uint64_t load_pos(const std::atomic<std::uint64_t> &pos) noexcept {
+        return pos.load(std::memory_order_acquire);
+    }
+    static std::uint64_t load_pos(const std::uint64_t &pos) noexcept { return pos; }
+
+    // Reclama con CAS la siguiente posición cuya ranura está lista para este lado
+    // ('lag' 0 productor, 1 consumidor). nullptr si está lleno/vacío.
+    Slot *claim(std::atomic<std::uint64_t> &counter, std::uint64_t lag, std::uint64_t &pos_out) noexcept {
+        std::uint64_t pos = counter.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot &slot = slots_[pos & mask];
+            std::uint64_t seq = slot.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::int64_t>(seq - (pos + lag));
+            if (diff == 0) {
+                if (counter.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed,
+                                                  std::memory_order_relaxed)) {
+                    pos_out = pos;
+                    return &slot;
+                }
+            } else if (diff < 0) {
+                cpu_relax();
+                return nullptr;
+            } else {
+                pos = counter.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Línea del consumidor (con su copia de 'tail' en SPSC) y del productor (con su
+    // copia de 'head'), como en el core en C.
+    alignas(cache_line_size) ConsumerPos head_;
+    std::uint64_t cached_tail_ = 0;
+    alignas(cache_line_size) std::atomic<std::uint64_t> tail_;
+    std::uint64_t cached_head_ = 0;
+    alignas(cache_line_size) Slot slots_[Capacity];
+};
+
+} // namespace aerb
+
+#endif // AERB_RING_HPP
@@ -0,0 +1,294 @@
+// Pruebas de aerb_ring.hpp (C++17). Compilado con -std=c++20 añade las de
+// aerb_coro.hpp.
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "aerb_ring.hpp"
+#if __cplusplus >= 202002L
+#include "aerb_coro.hpp"
+#endif
+
+static int checks_failed = 0;
+
+#define CHECK(cond)                                                                \
+    do {                                                                           \
+        if (!(cond)) {                                                             \
+            std::fprintf(stderr, "CHECK fallido (%s:%d): %s\n", __FILE__, __LINE__, #cond); \
+            checks_failed++;                                                       \
+        }                                                                          \
+    } while (0)
+
+// FIFO, lleno/vacío y elementos solo-movibles con las tres políticas.
+template <class Policy>
+static void check_fifo() {
+    auto ring = std::make_unique<aerb::Ring<std::unique_ptr<int>, 4, Policy>>();
+    CHECK(ring->empty() && !ring->full());
+    for (int i = 0; i < 4; i++) {
+        CHECK(ring->try_push(std::make_unique<int>(i)));
+    }
+    CHECK(ring->full() && ring->size() == 4);
+    auto extra = std::make_unique<int>(99);
+    CHECK(!ring->try_push(std::move(extra)));
+    CHECK(extra != nullptr && *extra == 99); // Lleno: el argumento no se toca
+    std::unique_ptr<int> out;
+    for (int i = 0; i < 4; i++) {
+        CHECK(ring->try_pop(out) && out != nullptr && *out == i);
+    }
+    CHECK(!ring->try_pop(out) && ring->empty());
+    // Otra vuelta entera: las ranuras se reutilizan.
+    for (int i = 0; i < 6; i++) {
+        CHECK(ring->emplace(new int(i)));
+        CHECK(ring->try_pop(out) && *out == i);
+    }
+}
+
+// Constructor que puede lanzar: con sellos, una excepción no deja la ranura reclamada.
+struct Picky {
+    int value;
+    explicit Picky(int v) : value(v) {
+        if (v < 0) {
+            throw std::invalid_argument("Picky");
+        }
+    }
+    Picky(Picky &&) noexcept = default;
+    Picky &operator=(Picky &&) noexcept = default;
+};
+
+// Se construye desde un std::string por valor-r y puede lanzar.
+struct Named {
+    std::string name;
+    explicit Named(std::string &&n) : name(std::move(n)) {
+        if (name.empty()) {
+            throw std::invalid_argument("Named");
+        }
+    }
+    Named(Named &&) noexcept = default;
+    Named &operator=(Named &&) noexcept = default;
+};
+
+static void check_throwing_constructor() {
+    auto ring = std::make_unique<aerb::Ring<Picky, 2, aerb::mpmc>>();
+    bool thrown = false;
+    try {
+        ring->emplace(-1);
+    } catch (const std::invalid_argument &) {
+        thrown = true;
+    }
+    CHECK(thrown && ring->empty());
+    CHECK(ring->emplace(1) && ring->emplace(2) && !ring->emplace(3));
+    Picky out(0);
+    CHECK(ring->try_pop(out) && out.value == 1);
+    CHECK(ring->try_pop(out) && out.value == 2);
+    CHECK(!ring->try_pop(out));
+
+    // std::string: copiar puede lanzar (va por el camino de construir antes de reclamar).
+    auto strings = std::make_unique<aerb::Ring<std::string, 2, aerb::mpsc>>();
+    const std::string hello = "hola";
+    CHECK(strings->try_push(hello) && strings->try_push(std::string("adiós")));
+    std::string s;
+    CHECK(strings->try_pop(s) && s == "hola" && hello == "hola");
+    CHECK(strings->try_pop(s) && s == "adiós");
+
+    // Lleno: el constructor que puede lanzar no llega a ejecutarse y el valor-r sigue intacto.
+    auto named = std::make_unique<aerb::Ring<Named, 2, aerb::mpmc>>();
+    CHECK(named->emplace(std::string("a")) && named->emplace(std::string("b")));
+    std::string arg = "c";
+    CHECK(!named->emplace(std::move(arg)) && arg == "c");
+}
+
+// Varios productores y consumidores: cada valor sale una vez y en orden por productor.
+static void check_mpmc_threads() {
+    constexpr int producers = 3;
+    constexpr int consumers = 2;
+    constexpr std::uint32_t per_producer = 20000;
+    auto ring = std::make_unique<aerb::Ring<std::uint64_t, 64, aerb::mpmc>>();
+    std::atomic<std::uint64_t> consumed{0};
+    std::vector<std::vector<std::uint32_t>> last(consumers, std::vector<std::uint32_t>(producers, 0));
+    std::atomic<bool> ordered{true};
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([&, p] {
+            for (std::uint32_t i = 1; i <= per_producer; i++) {
+                while (!ring->try_push((std::uint64_t(p) << 32) | i)) {
+                    sched_yield();
+                }
+            }
+        });
+    }
+    for (int c = 0; c < consumers; c++) {
+        threads.emplace_back([&, c] {
+            std::uint64_t v;
+            while (consumed.load(std::memory_order_relaxed) < std::uint64_t(producers) * per_producer) {
+                if (!ring->try_pop(v)) {
+                    sched_yield();
+                    continue;
+                }
+                auto p = static_cast<std::size_t>(v >> 32);
+                auto i = static_cast<std::uint32_t>(v);
+                if (p >= producers || i <= last[c][p]) {
+                    ordered.store(false, std::memory_order_relaxed);
+                } else {
+                    last[c][p] = i;
+                }
+                consumed.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    CHECK(ordered.load());
+    CHECK(consumed.load() == std::uint64_t(producers) * per_producer);
+    CHECK(ring->empty());
+}
+
+// Memoria compartida: el segmento se crea una vez y se mapea otra, como desde otro proceso.
+static void check_shared() {
+    using SharedRing = aerb::Ring<std::uint64_t, 8, aerb::spsc>;
+    char name[64];
+    std::snprintf(name, sizeof(name), "/aerb-test-%d", static_cast<int>(getpid()));
+    SharedRing *creator = SharedRing::create_shared(name);
+    CHECK(creator != nullptr);
+    if (creator == nullptr) {
+        return;
+    }
+    CHECK(SharedRing::create_shared(name) == nullptr); // Ya existe
+    SharedRing *attached = SharedRing::attach_shared(name);
+    CHECK(attached != nullptr);
+    using OtherRing = aerb::Ring<std::uint32_t, 8, aerb::spsc>;
+    CHECK(OtherRing::attach_shared(name) == nullptr && errno == EINVAL); // Otro layout
+    if (attached != nullptr) {
+        CHECK(creator->try_push(42));
+        std::uint64_t v = 0;
+        CHECK(attached->try_pop(v) && v == 42);
+        SharedRing::unmap_shared(attached);
+    }
+    SharedRing::unmap_shared(creator);
+    shm_unlink(name);
+}
+
+#if __cplusplus >= 202002L
+// Corrutina que arranca al crearla y libera su frame al terminar.
+struct Detached {
+    struct promise_type {
+        Detached get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+template <class R>
+static Detached pop_into(R &ring, int &out, bool &done) {
+    out = co_await ring.pop();
+    done = true;
+}
+
+template <class R>
+static Detached push_all(R &ring, int first, int count, std::atomic<bool> &done) {
+    for (int i = 0; i < count; i++) {
+        co_await ring.push(first + i);
+    }
+    done.store(true, std::memory_order_release); // Puede terminar en el hilo que la despertó
+}
+
+// Consume hasta el centinela 0 y acumula lo que ve.
+template <class R>
+static Detached sum_until_zero(R &ring, std::atomic<std::uint64_t> &sum, std::atomic<int> &finished) {
+    for (;;) {
+        int v = co_await ring.pop();
+        if (v == 0) {
+            break;
+        }
+        sum.fetch_add(static_cast<std::uint64_t>(v), std::memory_order_relaxed);
+    }
+    finished.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Un solo hilo: pop suspende con el ring vacío y push con el ring lleno; el lado
+// contrario completa la operación y reanuda la corrutina en línea.
+static void check_coro_suspend() {
+    auto ring = std::make_unique<aerb::AsyncRing<int, 2>>();
+    int got = 0;
+    bool popped = false;
+    pop_into(*ring, got, popped);
+    CHECK(!popped); // Vacío: suspendida
+    int v = 7;
+    CHECK(ring->try_push(std::move(v)));
+    CHECK(popped && got == 7 && ring->size() == 0);
+
+    std::atomic<bool> pushed{false};
+    push_all(*ring, 1, 5, pushed);
+    CHECK(!pushed && ring->size() == 2); // Lleno tras dos; espera con el tercero dentro
+    int out = 0;
+    for (int i = 1; i <= 5; i++) {
+        CHECK(ring->try_pop(out) && out == i);
+    }
+    CHECK(pushed && !ring->try_pop(out));
+}
+
+// Productores en varios hilos y consumidores suspendidos: nada se pierde ni se queda dormido.
+static void check_coro_threads() {
+    constexpr int producers = 2;
+    constexpr int consumers = 3;
+    constexpr int per_producer = 5000;
+    auto ring = std::make_unique<aerb::AsyncRing<int, 8>>();
+    std::atomic<std::uint64_t> sum{0};
+    std::atomic<int> finished{0};
+    for (int c = 0; c < consumers; c++) {
+        sum_until_zero(*ring, sum, finished);
+    }
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([&, p] {
+            std::atomic<bool> flag{false};
+            push_all(*ring, 1 + p * per_producer, per_producer, flag);
+            while (!flag.load(std::memory_order_acquire)) {
+                sched_yield(); // La corrutina sigue en otros hilos cuando la despiertan
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    for (int c = 0; c < consumers; c++) {
+        int zero = 0;
+        while (!ring->try_push(std::move(zero))) {
+            sched_yield();
+        }
+    }
+    std::uint64_t n = std::uint64_t(producers) * per_producer;
+    CHECK(finished.load() == consumers);
+    CHECK(sum.load() == n * (n + 1) / 2);
+    CHECK(ring->size() == 0);
+}
+#endif
+
+int main() {
+    check_fifo<aerb::spsc>();
+    check_fifo<aerb::mpsc>();
+    check_fifo<aerb::mpmc>();
+    check_throwing_constructor();
+    check_mpmc_threads();
+    check_shared();
+#if __cplusplus >= 202002L
+    check_coro_suspend();
+    check_coro_threads();
+#endif
+    std::printf("aerb (C++%ld): %s\n", __cplusplus / 100 % 100, checks_failed == 0 ? "OK" : "FAILED");
+    return checks_failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,1081 @@
+#define _GNU_SOURCE // syscall() para el futex
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <linux/mempolicy.h>
+
+#include "atomic_event_ring_buffer.h"
+#include "ring_internal.h"
+
+// Opciones que se pueden pedir al crear un ring.
+#define RING_CREATE_FLAGS (RING_FLAG_LATENCY | RING_FLAG_OVERWRITE)
+
+// Combinaciones válidas: el sello de latencia no está protegido por el seqlock de las
+// ranuras sobrescribibles.
+static inline int ring_flags_valid(uint32_t flags) {
+    return (flags & ~RING_CREATE_FLAGS) == 0 &&
+           (flags & (RING_FLAG_LATENCY | RING_FLAG_OVERWRITE)) != (RING_FLAG_LATENCY | RING_FLAG_OVERWRITE);
+}
+
+// --- LAYOUT DE LA RESERVA ---
+// [cabecera][ranuras][sellos de tiempo][histogramas], estos dos solo con RING_FLAG_LATENCY.
+// Todo se localiza por desplazamiento desde la cabecera, sin punteros.
+static inline size_t ring_latency_offset(uint64_t capacity) {
+    size_t bytes = sizeof(AtomicEventRingBuffer) + capacity * (sizeof(EventSlot) + sizeof(uint64_t));
+    return (bytes + CACHE_LINE_SIZE - 1) & ~(size_t)(CACHE_LINE_SIZE - 1);
+}
+
+static size_t ring_bytes(uint64_t capacity, uint32_t flags) {
+    if (flags & RING_FLAG_LATENCY) {
+        return ring_latency_offset(capacity) + RING_LATENCY_MAX_CONSUMERS * sizeof(RingLatencyHistogram);
+    }
+    return sizeof(AtomicEventRingBuffer) + capacity * sizeof(EventSlot);
+}
+
+static inline uint64_t *ring_stamps(AtomicEventRingBuffer *rb) {
+    return (uint64_t *)&rb->buffer[rb->capacity];
+}
+
+static inline RingLatencyHistogram *ring_latency_table(AtomicEventRingBuffer *rb) {
+    return (RingLatencyHistogram *)((char *)rb + ring_latency_offset(rb->capacity));
+}
+
+// --- INICIALIZACIÓN ---
+static void ring_buffer_init(AtomicEventRingBuffer *rb, uint64_t capacity, uint32_t flags) {
+    rb->version = RING_LAYOUT_VERSION;
+    rb->header_size = sizeof(AtomicEventRingBuffer);
+    rb->slot_size = sizeof(EventSlot);
+    rb->flags = flags;
+    rb->capacity = capacity;
+    rb->mask = capacity - 1;
+    rb->map_bytes = 0;
+    atomic_store_explicit(&rb->head, 0, memory_order_relaxed);
+    atomic_store_explicit(&rb->tail, 0, memory_order_relaxed);
+    atomic_store_explicit(&rb->lost, 0, memory_order_relaxed);
+    RingWaitQueue *queues[] = { &rb->consumer_wait, &rb->producer_wait };
+    for (size_t i = 0; i < 2; i++) {
+        atomic_store_explicit(&queues[i]->waiters, 0, memory_order_relaxed);
+        atomic_store_explicit(&queues[i]->futex, 0, memory_order_relaxed);
+        atomic_store_explicit(&queues[i]->armed, 0, memory_order_relaxed);
+        queues[i]->eventfd = -1;
+    }
+    ring_buffer_set_wait_policy(rb, &RING_WAIT_POLICY_DEFAULT);
+    if (flags & RING_FLAG_OVERWRITE) {
+        // Sello 0: ninguna posición publicada todavía (ver overwrite_publish).
+        for (uint64_t i = 0; i < capacity; i++) {
+            atomic_store_explicit(&rb->buffer[i].sequence, 0, memory_order_relaxed);
+        }
+    } else {
+        ring_init_slots(rb->buffer, capacity);
+    }
+    if (flags & RING_FLAG_LATENCY) {
+        // Los sellos no: cada uno se escribe antes de publicar su ranura.
+        memset(ring_latency_table(rb), 0, RING_LATENCY_MAX_CONSUMERS * sizeof(RingLatencyHistogram));
+    }
+    // Publica la inicialización antes de que el buffer se comparta con otros hilos:
+    // quien lea la firma con acquire ve el ring completo.
+    atomic_store_explicit(&rb->magic, RING_LAYOUT_MAGIC, memory_order_release);
+    ring_log("Ring Buffer: Inicializado (%" PRIu64 " ranuras).\n", capacity);
+}
+
+// --- CREACIÓN / DESTRUCCIÓN ---
+AtomicEventRingBuffer *ring_buffer_create(uint64_t capacity) {
+    return ring_buffer_create_ex(capacity, 0);
+}
+
+AtomicEventRingBuffer *ring_buffer_create_ex(uint64_t capacity, uint32_t flags) {
+    capacity = ring_normalize_capacity(capacity);
+    if (capacity == 0 || !ring_flags_valid(flags)) {
+        return NULL;
+    }
+
+    // Cabecera y ranuras en una sola reserva alineada a línea de caché.
+    AtomicEventRingBuffer *rb = ring_alloc(ring_bytes(capacity, flags));
+    if (rb == NULL) {
+        return NULL;
+    }
+    ring_buffer_init(rb, capacity, flags);
+    return rb;
+}
+
+// Bytes del segmento compartido: el layout completo, redondeado a página.
+static size_t ring_shared_bytes(uint64_t capacity, uint32_t flags) {
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t bytes = ring_bytes(capacity, flags);
+    return (bytes + page - 1) & ~(page - 1);
+}
+
+// --- RESERVA CON MMAP (ring_buffer_create_alloc) ---
+#ifndef MADV_POPULATE_WRITE
+#define MADV_POPULATE_WRITE 23 // Linux 5.14
+#endif
+#define RING_NUMA_MAX_NODES 1024
+
+// Tamaño de huge page por defecto del kernel (el de MAP_HUGETLB); 2 MiB si no se sabe.
+static size_t ring_huge_page_size(void) {
+    size_t size = 2u << 20;
+    FILE *f = fopen("/proc/meminfo", "r");
+    if (f == NULL) {
+        return size;
+    }
+    char line[128];
+    unsigned long kib;
+    while (fgets(line, sizeof(line), f) != NULL) {
+        if (sscanf(line, "Hugepagesize: %lu kB", &kib) == 1) {
+            size = (size_t)kib << 10;
+            break;
+        }
+    }
+    fclose(f);
+    return size;
+}
+
+// Tamaño de huge page de THP (PMD); puede no coincidir con el de hugetlb. 2 MiB si no se sabe.
+static size_t ring_thp_size(void) {
+    size_t size = 2u << 20;
+    FILE *f = fopen("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size", "r");
+    if (f == NULL) {
+        return size;
+    }
+    unsigned long bytes;
+    if (fscanf(f, "%lu", &bytes) == 1 && bytes != 0 && (bytes & (bytes - 1)) == 0) {
+        size = (size_t)bytes;
+    }
+    fclose(f);
+    return size;
+}
+
+// Región anónima alineada a huge page y marcada para THP. Si el kernel no admite
+// MADV_HUGEPAGE se recorta a páginas normales y '*got' queda sin RING_FLAG_THP.
+// '*len_out' recibe la longitud que queda mapeada.
+static void *ring_map_thp(size_t bytes, size_t huge, int mmap_flags, uint32_t *got, size_t *len_out) {
+    size_t len = (bytes + huge - 1) & ~(huge - 1);
+    char *raw = mmap(NULL, len + huge, PROT_READ | PROT_WRITE, mmap_flags, -1, 0);
+    if (raw == MAP_FAILED) {
+        return MAP_FAILED;
+    }
+    char *base = (char *)(((uintptr_t)raw + huge - 1) & ~(uintptr_t)(huge - 1));
+    if (base > raw) {
+        munmap(raw, (size_t)(base - raw));
+    }
+    if (raw + huge > base) {
+        munmap(base + len, (size_t)(raw + huge - base));
+    }
+    if (madvise(base, len, MADV_HUGEPAGE) == 0) {
+        *got |= RING_FLAG_THP;
+        *len_out = len;
+        return base;
+    }
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t short_len = (bytes + page - 1) & ~(page - 1);
+    if (short_len < len) {
+        munmap(base + short_len, len - short_len);
+    }
+    *len_out = short_len;
+    return base;
+}
+
+// mbind(MPOL_PREFERRED): si el nodo se queda sin memoria se usa otro en vez de fallar.
+// Con RING_NUMA_LOCAL es solo una preferencia: si no hay información de nodo o el mbind
+// falla (ENOSYS sin NUMA, EPERM bajo seccomp) se queda con la primera escritura.
+static int ring_bind_node(void *base, size_t len, int32_t node) {
+    int local_only = node == RING_NUMA_LOCAL;
+    if (local_only) {
+        unsigned cpu, local;
+        if (getcpu(&cpu, &local) != 0) {
+            return 0;
+        }
+        node = (int32_t)local;
+    }
+    if (node < 0 || node >= RING_NUMA_MAX_NODES) {
+        errno = EINVAL;
+        return -1;
+    }
+    unsigned long mask[RING_NUMA_MAX_NODES / (8 * sizeof(unsigned long))] = { 0 };
+    mask[node / (8 * sizeof(unsigned long))] = 1UL << (node % (8 * sizeof(unsigned long)));
+    // maxnode cuenta un bit de más (así lo espera el kernel, igual que libnuma).
+    if (syscall(SYS_mbind, base, len, MPOL_PREFERRED, mask, RING_NUMA_MAX_NODES + 1, 0) != 0) {
+        if (!local_only) {
+            return -1;
+        }
+        ring_log("Ring Buffer: mbind al nodo %d falló (errno %d); sin preferencia NUMA.\n", node, errno);
+    }
+    return 0;
+}
+
+static void ring_populate(void *base, size_t len) {
+    if (madvise(base, len, MADV_POPULATE_WRITE) == 0) {
+        return;
+    }
+    // Kernel anterior a 5.14: una escritura por página (la memoria ya está a cero).
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    for (size_t off = 0; off < len; off += page) {
+        ((volatile char *)base)[off] = 0;
+    }
+}
+
+AtomicEventRingBuffer *ring_buffer_create_alloc(uint64_t capacity, uint32_t flags, const RingAllocPolicy *alloc) {
+    capacity = ring_normalize_capacity(capacity);
+    if (capacity == 0 || !ring_flags_valid(flags)) {
+        errno = EINVAL;
+        return NULL;
+    }
+    RingAllocPolicy policy = alloc != NULL ? *alloc : RING_ALLOC_POLICY_DEFAULT;
+    int entry_errno = errno; // Los intentos fallidos (MAP_HUGETLB, mbind local) no se ven al salir bien
+    int bind = policy.numa_node != RING_NUMA_ANY;
+    // Sin mbind el prefault puede ir en el propio mmap; con mbind, después de él.
+    int mmap_flags = MAP_PRIVATE | MAP_ANONYMOUS | (policy.populate && !bind ? MAP_POPULATE : 0);
+    size_t bytes = ring_bytes(capacity, flags);
+    uint32_t got = RING_FLAG_MAPPED;
+    void *base = MAP_FAILED;
+    size_t len;
+
+    if (policy.huge_pages) {
+        size_t huge = ring_huge_page_size();
+        len = (bytes + huge - 1) & ~(huge - 1);
+        base = mmap(NULL, len, PROT_READ | PROT_WRITE, mmap_flags | MAP_HUGETLB, -1, 0);
+        if (base != MAP_FAILED) {
+            got |= RING_FLAG_HUGETLB;
+        } else {
+            base = ring_map_thp(bytes, ring_thp_size(), mmap_flags, &got, &len);
+        }
+    } else {
+        size_t page = (size_t)sysconf(_SC_PAGESIZE);
+        len = (bytes + page - 1) & ~(page - 1);
+        base = mmap(NULL, len, PROT_READ | PROT_WRITE, mmap_flags, -1, 0);
+    }
+    if (base == MAP_FAILED) {
+        return NULL;
+    }
+
+    if (bind && ring_bind_node(base, len, policy.numa_node) != 0) {
+        int saved = errno;
+        munmap(base, len);
+        errno = saved;
+        return NULL;
+    }
+    if (policy.populate && bind) {
+        ring_populate(base, len);
+    }
+
+    AtomicEventRingBuffer *rb = base;
+    ring_buffer_init(rb, capacity, flags | got);
+    rb->map_bytes = len; // munmap con lo que se mapeó, no con lo que se recalcule al destruir
+    ring_log("Ring Buffer: %zu bytes en %s.\n", len,
+             (got & RING_FLAG_HUGETLB) ? "hugetlb" : (got & RING_FLAG_THP) ? "THP" : "páginas normales");
+    errno = entry_errno;
+    return rb;
+}
+
+void ring_buffer_destroy(AtomicEventRingBuffer *rb) {
+    if (rb->consumer_wait.eventfd >= 0) {
+        close(rb->consumer_wait.eventfd);
+    }
+    if (rb->flags & RING_FLAG_SHARED) {
+        munmap(rb, ring_shared_bytes(rb->capacity, rb->flags));
+    } else if (rb->flags & RING_FLAG_MAPPED) {
+        munmap(rb, rb->map_bytes);
+    } else {
+        free(rb);
+    }
+}
+
+// --- RING EN MEMORIA COMPARTIDA ---
+AtomicEventRingBuffer *ring_buffer_create_shared(const char *name, uint64_t capacity) {
+    return ring_buffer_create_shared_ex(name, capacity, 0);
+}
+
+AtomicEventRingBuffer *ring_buffer_create_shared_ex(const char *name, uint64_t capacity, uint32_t flags) {
+    capacity = ring_normalize_capacity(capacity);
+    if (capacity == 0 || !ring_flags_valid(flags)) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    size_t bytes = ring_shared_bytes(capacity, flags);
+    if (ftruncate(fd, (off_t)bytes) != 0) {
+        int saved = errno;
+        close(fd);
+        shm_unlink(name);
+        errno = saved;
+        return NULL;
+    }
+
+    AtomicEventRingBuffer *rb = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    int saved = errno;
+    close(fd); // El mapeo mantiene vivo el segmento
+    if (rb == MAP_FAILED) {
+        shm_unlink(name);
+        errno = saved;
+        return NULL;
+    }
+
+    // ftruncate deja el segmento a cero, así que 'magic' sigue a 0 (no listo)
+    // hasta que ring_buffer_init lo publica al final.
+    ring_buffer_init(rb, capacity, flags | RING_FLAG_SHARED);
+    return rb;
+}
+
+AtomicEventRingBuffer *ring_buffer_attach(const char *name) {
+    int fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        return NULL;
+    }
+    if ((size_t)st.st_size < sizeof(AtomicEventRingBuffer)) {
+        close(fd);
+        errno = EAGAIN; // Creado pero aún sin tamaño
+        return NULL;
+    }
+
+    size_t bytes = (size_t)st.st_size;
+    AtomicEventRingBuffer *rb = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    int saved = errno;
+    close(fd);
+    if (rb == MAP_FAILED) {
+        errno = saved;
+        return NULL;
+    }
+
+    // acquire: si la firma está, el resto de la inicialización del creador es visible.
+    uint32_t magic = atomic_load_explicit(&rb->magic, memory_order_acquire);
+    int err = 0;
+    if (magic == 0) {
+        err = EAGAIN;
+    } else if (magic != RING_LAYOUT_MAGIC || rb->version != RING_LAYOUT_VERSION ||
+               rb->header_size != sizeof(AtomicEventRingBuffer) || rb->slot_size != sizeof(EventSlot) ||
+               !(rb->flags & RING_FLAG_SHARED) || !ring_flags_valid(rb->flags & ~RING_FLAG_SHARED) ||
+               ring_normalize_capacity(rb->capacity) != rb->capacity ||
+               ring_shared_bytes(rb->capacity, rb->flags) != bytes) {
+        err = EINVAL;
+    }
+    if (err != 0) {
+        munmap(rb, bytes);
+        errno = err;
+        return NULL;
+    }
+    return rb;
+}
+
+int ring_buffer_unlink_shared(const char *name) {
+    return shm_unlink(name);
+}
+
+// --- RESERVA DE RANURAS ---
+// Ambos lados del MPMC están contendidos: productores y consumidores reclaman con CAS.
+static inline EventSlot *claim_producer_slot(AtomicEventRingBuffer *rb, uint64_t *pos_out) {
+    return ring_claim_slot(&rb->tail, rb->buffer, rb->mask, SLOT_LAG_PRODUCER, pos_out);
+}
+
+static inline EventSlot *claim_consumer_slot(AtomicEventRingBuffer *rb, uint64_t *pos_out) {
+    return ring_claim_slot(&rb->head, rb->buffer, rb->mask, SLOT_LAG_CONSUMER, pos_out);
+}
+
+// --- DESPERTAR AL LADO OPUESTO ---
+// Se llama tras ceder ranuras al otro lado. Las lecturas seq_cst de 'waiters' y 'armed'
+// quedan ordenadas después del CAS seq_cst que reclamó la posición: o este hilo ve al
+// que espera registrado (o el eventfd armado) y lo despierta, o el que espera ve el
+// contador avanzado y no se duerme (ver ring_wait y ring_eventfd_arm). Sin nadie
+// esperando el coste son dos lecturas de una línea casi siempre compartida, sin syscall.
+static inline void wake_waiters(AtomicEventRingBuffer *rb, RingWaitQueue *q, size_t count) {
+    if (atomic_load_explicit(&q->waiters, memory_order_seq_cst) != 0) {
+        atomic_fetch_add_explicit(&q->futex, 1, memory_order_seq_cst);
+        futex_wake(&q->futex, count > INT32_MAX ? INT32_MAX : (int)count, rb->flags & RING_FLAG_SHARED);
+    }
+    // Solo un productor gana el exchange: una escritura por armado.
+    if (atomic_load_explicit(&q->armed, memory_order_seq_cst) != 0 &&
+        atomic_exchange_explicit(&q->armed, 0, memory_order_seq_cst) != 0) {
+        uint64_t one = 1;
+        ssize_t written = write(q->eventfd, &one, sizeof(one));
+        (void)written; // Solo falla si el contador satura: ya hay una notificación pendiente
+    }
+}
+
+static inline void wake_consumers(AtomicEventRingBuffer *rb, size_t count) {
+    wake_waiters(rb, &rb->consumer_wait, count);
+}
+
+static inline void wake_producers(AtomicEventRingBuffer *rb, size_t count) {
+    wake_waiters(rb, &rb->producer_wait, count);
+}
+
+void ring_wake_producers(AtomicEventRingBuffer *rb, size_t count) {
+    wake_producers(rb, count);
+}
+
+// Pasa de la dirección de un evento a la de la ranura que lo contiene.
+static inline EventSlot *slot_of(Event *event) {
+    return (EventSlot *)((char *)event - offsetof(EventSlot, event));
+}
+
+// --- MEDIDA DE LATENCIA ---
+// El sello es un store normal en el array de sellos, antes del store-release que publica
+// la ranura; el consumidor lo lee tras su load-acquire del sello de secuencia. Así la
+// medida no añade ningún atómico al camino del ring.
+static inline void latency_stamp(AtomicEventRingBuffer *rb, uint64_t pos, size_t n) {
+    if (rb->flags & RING_FLAG_LATENCY) {
+        uint64_t now = monotonic_ns();
+        uint64_t *stamps = ring_stamps(rb);
+        for (size_t i = 0; i < n; i++) {
+            stamps[(pos + i) & rb->mask] = now;
+        }
+    }
+}
+
+// TID del hilo (una syscall por hilo) y último histograma usado, por ring.
+static _Thread_local uint32_t latency_tid;
+static _Thread_local const AtomicEventRingBuffer *latency_ring;
+static _Thread_local RingLatencyHistogram *latency_hist;
+
+// ¿Sigue vivo el hilo 'tid'? kill(tid, 0) no envía nada; solo ESRCH significa que no
+// existe (EPERM: existe, pero es de otro usuario).
+static int latency_owner_alive(uint32_t tid) {
+    return kill((pid_t)tid, 0) == 0 || errno != ESRCH;
+}
+
+// Busca el histograma de este hilo en la tabla del ring, o toma uno libre.
+// Solo se ejecuta la primera vez que el hilo consume de un ring (o al alternar entre
+// rings). Con la tabla llena hereda la entrada de un hilo que ya terminó, con sus
+// cuentas (siguen sumando en el snapshot). Retorna NULL si los
+// RING_LATENCY_MAX_CONSUMERS dueños siguen vivos: ese consumidor no se mide.
+static RingLatencyHistogram *latency_lookup(AtomicEventRingBuffer *rb) {
+    if (latency_tid == 0) {
+        latency_tid = (uint32_t)syscall(SYS_gettid);
+    }
+    RingLatencyHistogram *table = ring_latency_table(rb);
+    for (size_t i = 0; i < RING_LATENCY_MAX_CONSUMERS; i++) {
+        if (atomic_load_explicit(&table[i].owner, memory_order_relaxed) == latency_tid) {
+            return &table[i];
+        }
+    }
+    for (size_t i = 0; i < RING_LATENCY_MAX_CONSUMERS; i++) {
+        uint32_t expected = 0;
+        if (atomic_compare_exchange_strong_explicit(&table[i].owner, &expected, latency_tid,
+                                                    memory_order_relaxed, memory_order_relaxed)) {
+            return &table[i];
+        }
+    }
+    int saved = errno;
+    RingLatencyHistogram *h = NULL;
+    for (size_t i = 0; i < RING_LATENCY_MAX_CONSUMERS && h == NULL; i++) {
+        uint32_t owner = atomic_load_explicit(&table[i].owner, memory_order_relaxed);
+        // El dueño anterior ya salió (y con él, por el kernel, sus últimos stores): el
+        // nuevo sigue sumando sobre sus cuentas como único escritor.
+        if (!latency_owner_alive(owner) &&
+            atomic_compare_exchange_strong_explicit(&table[i].owner, &owner, latency_tid,
+                                                    memory_order_relaxed, memory_order_relaxed)) {
+            h = &table[i];
+        }
+    }
+    errno = saved;
+    return h;
+}
+
+static inline size_t latency_bucket(uint64_t ns) {
+    if (ns < 2 * RING_LATENCY_SUB_BUCKETS) {
+        return (size_t)ns;
+    }
+    unsigned shift = 63 - (unsigned)__builtin_clzll(ns) - RING_LATENCY_SUB_BITS;
+    return (size_t)(shift + 1) * RING_LATENCY_SUB_BUCKETS + (size_t)(ns >> shift) - RING_LATENCY_SUB_BUCKETS;
+}
+
+// Registra la latencia de las posiciones [pos, pos + n), ya reclamadas por este consumidor.
+// Un solo escritor por histograma: ring_counter_add, sin RMW.
+static inline void latency_record(AtomicEventRingBuffer *rb, uint64_t pos, size_t n) {
+    if (!(rb->flags & RING_FLAG_LATENCY)) {
+        return;
+    }
+    RingLatencyHistogram *h = latency_hist;
+    // Se comprueba el dueño por si el ring cacheado se destruyó y otro ocupa su dirección.
+    if (latency_ring != rb || h == NULL ||
+        atomic_load_explicit(&h->owner, memory_order_relaxed) != latency_tid) {
+        h = latency_lookup(rb);
+        latency_ring = rb;
+        latency_hist = h;
+        if (h == NULL) {
+            return;
+        }
+    }
+
+    uint64_t now = monotonic_ns();
+    const uint64_t *stamps = ring_stamps(rb);
+    uint64_t sum = 0;
+    uint64_t max = atomic_load_explicit(&h->max_ns, memory_order_relaxed);
+    for (size_t i = 0; i < n; i++) {
+        uint64_t stamp = stamps[(pos + i) & rb->mask];
+        uint64_t ns = now > stamp ? now - stamp : 0; // Relojes de CPUs distintas
+        ring_counter_add(&h->buckets[latency_bucket(ns)], 1);
+        sum += ns;
+        if (ns > max) {
+            max = ns;
+        }
+    }
+    ring_counter_add(&h->count, n);
+    ring_counter_add(&h->sum_ns, sum);
+    atomic_store_explicit(&h->max_ns, max, memory_order_relaxed);
+}
+
+// --- MODO SOBRESCRITURA ---
+// Los sellos van como seqlock (ver ring_seqlock_publish en ring_internal.h):
+//   sequence == 2 * pos + 1       -> el productor de 'pos' está escribiendo la ranura.
+//   sequence == 2 * (pos + 1)     -> publicada para el consumidor de 'pos'.
+// Así el sello solo crece y un valor mayor siempre es de una vuelta más reciente.
+
+// Escribe el evento de la posición 'pos', ya reclamada con fetch_add sobre 'tail'.
+static inline void overwrite_publish(AtomicEventRingBuffer *rb, uint64_t pos, const Event *event) {
+    ring_seqlock_publish(&rb->buffer[pos & rb->mask], pos, event);
+}
+
+static inline uint64_t overwrite_enqueue(AtomicEventRingBuffer *rb, const Event *events, size_t n) {
+    uint64_t pos = atomic_fetch_add_explicit(&rb->tail, n, memory_order_seq_cst);
+    RING_STAT_ADD(enqueue_ok, n);
+    for (size_t i = 0; i < n; i++) {
+        overwrite_publish(rb, pos + i, &events[i]);
+    }
+    wake_consumers(rb, n);
+    return pos;
+}
+
+// Extrae el evento más antiguo que sigue en el ring. Retorna -1 si está vacío.
+static int overwrite_dequeue(AtomicEventRingBuffer *rb, Event *event, uint64_t *seq_out, uint64_t *lost_out) {
+    uint64_t lost = 0;
+    uint64_t pos = atomic_load_explicit(&rb->head, memory_order_relaxed);
+
+    for (;;) {
+        EventSlot *slot = &rb->buffer[pos & rb->mask];
+        uint64_t published = 2 * (pos + 1);
+        uint64_t seq = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+
+        if (seq == published) {
+            Event copy = slot->event;
+            // Seqlock: si el sello no cambió durante la copia, la copia es íntegra.
+            atomic_thread_fence(memory_order_acquire);
+            if (atomic_load_explicit(&slot->sequence, memory_order_relaxed) == seq &&
+                atomic_compare_exchange_weak_explicit(&rb->head, &pos, pos + 1,
+                                                      memory_order_seq_cst, memory_order_relaxed)) {
+                RING_STAT_ADD(dequeue_ok, 1);
+                *event = copy;
+                if (seq_out != NULL) {
+                    *seq_out = pos;
+                }
+                if (lost_out != NULL) {
+                    *lost_out = lost;
+                }
+                return 0;
+            }
+            // Sobrescrita durante la copia, u otro consumidor se llevó 'pos': relee.
+            pos = atomic_load_explicit(&rb->head, memory_order_relaxed);
+        } else if (seq < published) {
+            // Nada publicado aún para 'pos' (o su productor está escribiendo).
+            RING_STAT_ADD(dequeue_empty, 1);
+            cpu_relax();
+            return -1;
+        } else {
+            // Los productores dieron la vuelta sobre 'pos': salta al evento más antiguo que
+            // puede seguir en el ring. Si otro consumidor mueve 'head' antes, se reintenta.
+            uint64_t tail = atomic_load_explicit(&rb->tail, memory_order_relaxed);
+            uint64_t oldest = tail - rb->capacity;
+            if ((int64_t)(oldest - pos) <= 0) {
+                oldest = pos + 1; // 'tail' leído aún no refleja la vuelta: al menos salta 'pos'
+            }
+            if (atomic_compare_exchange_weak_explicit(&rb->head, &pos, oldest,
+                                                      memory_order_seq_cst, memory_order_relaxed)) {
+                atomic_fetch_add_explicit(&rb->lost, oldest - pos, memory_order_relaxed);
+                lost += oldest - pos;
+                pos = oldest;
+            }
+        }
+    }
+}
+
+int dequeue_event_lossy(AtomicEventRingBuffer *rb, Event *event, uint64_t *lost) {
+    if (!(rb->flags & RING_FLAG_OVERWRITE)) {
+        if (lost != NULL) {
+            *lost = 0;
+        }
+        return dequeue_event(rb, event);
+    }
+    if (overwrite_dequeue(rb, event, NULL, lost) != 0) {
+        return -1;
+    }
+    wake_producers(rb, 1);
+    return 0;
+}
+
+uint64_t ring_buffer_lost(AtomicEventRingBuffer *rb) {
+    return atomic_load_explicit(&rb->lost, memory_order_relaxed);
+}
+
+// --- ENQUEUE (Productor) ---
+// Añade un evento al buffer.
+// MPMC: Múltiples productores pueden llamar a esta función simultáneamente.
+// Retorna 0 en éxito, -1 si el buffer está lleno.
+int enqueue_event(AtomicEventRingBuffer *rb, const Event *event) {
+    return enqueue_event_seq(rb, event, NULL);
+}
+
+int enqueue_event_seq(AtomicEventRingBuffer *rb, const Event *event, uint64_t *seq_out) {
+    uint64_t pos;
+    if (rb->flags & RING_FLAG_OVERWRITE) {
+        pos = overwrite_enqueue(rb, event, 1);
+        if (seq_out != NULL) {
+            *seq_out = pos;
+        }
+        return 0; // Nunca lleno
+    }
+
+    EventSlot *slot = claim_producer_slot(rb, &pos);
+    if (slot == NULL) {
+        return -1; // Lleno
+    }
+
+    // La posición es nuestra: escribe el evento y publícalo en la ranura.
+    // memory_order_release: el evento es visible antes que el nuevo sello.
+    slot->event = *event;
+    latency_stamp(rb, pos, 1);
+    atomic_store_explicit(&slot->sequence, pos + 1, memory_order_release);
+    wake_consumers(rb, 1);
+    if (seq_out != NULL) {
+        *seq_out = pos;
+    }
+    return 0; // Éxito
+}
+
+// --- DEQUEUE (Consumidor) ---
+// Extrae un evento del buffer.
+// MPMC: Múltiples consumidores pueden llamar a esta función simultáneamente.
+// Retorna 0 en éxito, -1 si el buffer está vacío.
+int dequeue_event(AtomicEventRingBuffer *rb, Event *event) {
+    return dequeue_event_seq(rb, event, NULL);
+}
+
+int dequeue_event_seq(AtomicEventRingBuffer *rb, Event *event, uint64_t *seq_out) {
+    uint64_t pos;
+    if (rb->flags & RING_FLAG_OVERWRITE) {
+        if (overwrite_dequeue(rb, event, seq_out, NULL) != 0) {
+            return -1;
+        }
+        wake_producers(rb, 1);
+        return 0;
+    }
+
+    EventSlot *slot = claim_consumer_slot(rb, &pos);
+    if (slot == NULL) {
+        return -1; // Vacío
+    }
+
+    // Copia el evento y libera la ranura para la siguiente vuelta de productores.
+    *event = slot->event;
+    latency_record(rb, pos, 1);
+    atomic_store_explicit(&slot->sequence, pos + rb->capacity, memory_order_release);
+    wake_producers(rb, 1);
+    if (seq_out != NULL) {
+        *seq_out = pos;
+    }
+    return 0; // Éxito
+}
+
+// --- ESPERA BLOQUEANTE ---
+// Fase 1: spin con PAUSE. El presupuesto se adapta dentro de la política: crece cuando
+// el spin llegó a tiempo de completar la operación y decrece cuando no.
+// Fase 2: el hilo se registra en 'waiters' de su cola (RMW seq_cst), lee la palabra
+// futex y después el contador del lado opuesto (seq_cst). Si el otro lado no tiene
+// nada en curso que pueda liberarle, duerme en el futex: cualquier hilo opuesto cuyo
+// CAS sea posterior verá el registro y le despertará. Si hay posiciones reclamadas por
+// el otro lado y aún no cedidas, cede la CPU en lugar de dormir, porque ese hilo pudo
+// leer 'waiters' antes del registro.
+
+// ¿Hay algo en curso en el lado opuesto que vaya a permitir progresar sin despertar?
+// Productor: alguna posición por debajo de head + capacity sin reclamar por productores.
+// Consumidor: alguna posición reclamada por productores y no por consumidores.
+static inline int wait_has_pending(AtomicEventRingBuffer *rb, int producer) {
+    if (producer) {
+        uint64_t head = atomic_load_explicit(&rb->head, memory_order_seq_cst);
+        uint64_t tail = atomic_load_explicit(&rb->tail, memory_order_relaxed);
+        return (int64_t)(tail - head) < (int64_t)rb->capacity;
+    }
+    uint64_t tail = atomic_load_explicit(&rb->tail, memory_order_seq_cst);
+    uint64_t head = atomic_load_explicit(&rb->head, memory_order_relaxed);
+    return (int64_t)(tail - head) > 0;
+}
+
+static inline int wait_try(AtomicEventRingBuffer *rb, int producer, Event *event) {
+    return producer ? enqueue_event(rb, event) : dequeue_event(rb, event);
+}
+
+static int ring_wait(AtomicEventRingBuffer *rb, RingWaitQueue *q, int producer,
+                     Event *event, int64_t timeout_ns) {
+    const RingWaitPolicy *policy = &rb->wait_policy;
+    uint32_t budget = atomic_load_explicit(&q->spin, memory_order_relaxed);
+
+    for (uint32_t i = 0; i < budget; i++) {
+        RING_STAT_ADD(wait_spins, 1);
+        if (wait_try(rb, producer, event) == 0) {
+            if (i > 0 && budget < policy->spin_max) {
+                uint32_t grown = budget * 2;
+                atomic_store_explicit(&q->spin, grown < policy->spin_max ? grown : policy->spin_max,
+                                      memory_order_relaxed);
+            }
+            return 0;
+        }
+    }
+    if (budget > policy->spin_min) {
+        uint32_t shrunk = budget / 2;
+        atomic_store_explicit(&q->spin, shrunk > policy->spin_min ? shrunk : policy->spin_min,
+                              memory_order_relaxed);
+    }
+    if (budget == 0 && wait_try(rb, producer, event) == 0) {
+        return 0;
+    }
+    if (timeout_ns == 0) {
+        return -1;
+    }
+
+    uint64_t deadline = timeout_ns > 0 ? monotonic_ns() + (uint64_t)timeout_ns : 0;
+
+    for (;;) {
+        int pending = 1;
+
+        if (policy->park) {
+            atomic_fetch_add_explicit(&q->waiters, 1, memory_order_seq_cst);
+            uint32_t word = atomic_load_explicit(&q->futex, memory_order_seq_cst);
+            pending = wait_has_pending(rb, producer);
+
+            if (!pending) {
+                struct timespec ts;
+                struct timespec *timeout = NULL;
+                if (timeout_ns > 0) {
+                    uint64_t now = monotonic_ns();
+                    if (now >= deadline) {
+                        atomic_fetch_sub_explicit(&q->waiters, 1, memory_order_relaxed);
+                        return -1;
+                    }
+                    ts.tv_sec = (time_t)((deadline - now) / 1000000000ULL);
+                    ts.tv_nsec = (long)((deadline - now) % 1000000000ULL);
+                    timeout = &ts;
+                }
+                RING_STAT_ADD(wait_parks, 1);
+                futex_wait(&q->futex, word, timeout, rb->flags & RING_FLAG_SHARED);
+            }
+            atomic_fetch_sub_explicit(&q->waiters, 1, memory_order_relaxed);
+        }
+
+        if (wait_try(rb, producer, event) == 0) {
+            return 0;
+        }
+        if (pending) {
+            sched_yield(); // El otro lado está a mitad de ceder una ranura
+        }
+        if (timeout_ns > 0 && monotonic_ns() >= deadline) {
+            return -1;
+        }
+    }
+}
+
+// --- ENQUEUE / DEQUEUE BLOQUEANTES ---
+int enqueue_event_wait(AtomicEventRingBuffer *rb, const Event *event, int64_t timeout_ns) {
+    // ring_wait no modifica el evento en el lado productor.
+    return ring_wait(rb, &rb->producer_wait, 1, (Event *)event, timeout_ns);
+}
+
+int dequeue_event_wait(AtomicEventRingBuffer *rb, Event *event, int64_t timeout_ns) {
+    return ring_wait(rb, &rb->consumer_wait, 0, event, timeout_ns);
+}
+
+// --- POLÍTICA DE ESPERA ---
+// Normaliza los límites (spin_min <= spin_initial <= spin_max) y reinicia ambas colas.
+void ring_buffer_set_wait_policy(AtomicEventRingBuffer *rb, const RingWaitPolicy *policy) {
+    RingWaitPolicy p = *policy;
+    if (p.spin_min > p.spin_max) {
+        p.spin_min = p.spin_max;
+    }
+    // El presupuesto solo crece dentro del spin: si pudiera llegar a 0 no volvería a crecer.
+    if (p.spin_min == 0 && p.spin_max > 0) {
+        p.spin_min = 1;
+    }
+    if (p.spin_initial < p.spin_min) {
+        p.spin_initial = p.spin_min;
+    }
+    if (p.spin_initial > p.spin_max) {
+        p.spin_initial = p.spin_max;
+    }
+    rb->wait_policy = p;
+    atomic_store_explicit(&rb->consumer_wait.spin, p.spin_initial, memory_order_relaxed);
+    atomic_store_explicit(&rb->producer_wait.spin, p.spin_initial, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+}
+
+// --- NOTIFICACIÓN POR EVENTFD ---
+int ring_buffer_enable_eventfd(AtomicEventRingBuffer *rb) {
+    if (rb->flags & RING_FLAG_SHARED) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (rb->consumer_wait.eventfd < 0) {
+        int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (fd < 0) {
+            return -1;
+        }
+        rb->consumer_wait.eventfd = fd;
+    }
+    return rb->consumer_wait.eventfd;
+}
+
+// Mismo protocolo que ring_wait: se arma (seq_cst) y después se lee 'tail' (seq_cst).
+// Si ningún productor tiene posiciones sin consumir, cualquier productor posterior
+// verá el eventfd armado. Si las hay, se desarma y el consumidor sigue vaciando
+// (si un productor ya lo desarmó, queda una notificación de más, que es inocua).
+int ring_eventfd_arm(AtomicEventRingBuffer *rb) {
+    atomic_store_explicit(&rb->consumer_wait.armed, 1, memory_order_seq_cst);
+    uint64_t tail = atomic_load_explicit(&rb->tail, memory_order_seq_cst);
+    uint64_t head = atomic_load_explicit(&rb->head, memory_order_relaxed);
+    if ((int64_t)(tail - head) > 0) {
+        atomic_store_explicit(&rb->consumer_wait.armed, 0, memory_order_relaxed);
+        return 1;
+    }
+    return 0;
+}
+
+void ring_eventfd_ack(AtomicEventRingBuffer *rb) {
+    uint64_t count;
+    ssize_t got = read(rb->consumer_wait.eventfd, &count, sizeof(count));
+    (void)got; // EAGAIN si ya estaba a cero
+}
+
+// --- CLAIM / COMMIT (Productor, sin copia) ---
+// ring_claim reserva la siguiente ranura y devuelve el evento que contiene para que
+// el productor lo rellene en el sitio. Los consumidores no pasan de esa posición
+// hasta que se llama a ring_commit, así que la ventana entre ambas debe ser corta.
+// Retorna NULL si el buffer está lleno.
+Event *ring_claim(AtomicEventRingBuffer *rb) {
+    uint64_t pos;
+    if (rb->flags & RING_FLAG_OVERWRITE) {
+        return NULL; // Sin copia no hay forma de proteger la ranura de otro productor
+    }
+    EventSlot *slot = claim_producer_slot(rb, &pos);
+    return slot != NULL ? &slot->event : NULL;
+}
+
+// Publica un evento obtenido con ring_claim.
+// El sello sigue valiendo 'pos' (la ranura es nuestra), así que basta con sumarle 1.
+void ring_commit(AtomicEventRingBuffer *rb, Event *event) {
+    EventSlot *slot = slot_of(event);
+    uint64_t pos = atomic_load_explicit(&slot->sequence, memory_order_relaxed);
+    latency_stamp(rb, pos, 1);
+    atomic_store_explicit(&slot->sequence, pos + 1, memory_order_release);
+    wake_consumers(rb, 1);
+}
+
+// --- PEEK / RELEASE (Consumidor, sin copia) ---
+// ring_peek reclama el siguiente evento publicado y lo devuelve en la memoria del ring.
+// El evento queda reservado para este consumidor (otros consumidores siguen con las
+// posiciones siguientes) y puede leerse o modificarse hasta llamar a ring_release.
+// Retorna NULL si el buffer está vacío.
+Event *ring_peek(AtomicEventRingBuffer *rb) {
+    uint64_t pos;
+    if (rb->flags & RING_FLAG_OVERWRITE) {
+        return NULL;
+    }
+    EventSlot *slot = claim_consumer_slot(rb, &pos);
+    if (slot == NULL) {
+        return NULL;
+    }
+    latency_record(rb, pos, 1);
+    return &slot->event;
+}
+
+// Devuelve a los productores la ranura de un evento obtenido con ring_peek.
+// El sello vale 'pos + 1' (publicado), así que la siguiente vuelta es 'pos + capacity'.
+void ring_release(AtomicEventRingBuffer *rb, Event *event) {
+    EventSlot *slot = slot_of(event);
+    uint64_t seq = atomic_load_explicit(&slot->sequence, memory_order_relaxed);
+    atomic_store_explicit(&slot->sequence, seq - 1 + rb->capacity, memory_order_release);
+    wake_producers(rb, 1);
+}
+
+// --- ENQUEUE POR LOTES (Productor) ---
+// Añade hasta 'count' eventos reclamando un rango contiguo de posiciones con un solo CAS.
+// Solo reclama ranuras ya libres, así que nunca espera a un consumidor; la copia se
+// hace en dos tramos si el rango da la vuelta.
+// Retorna el número de eventos añadidos (0 si el buffer está lleno).
+size_t enqueue_events(AtomicEventRingBuffer *rb, const Event *events, size_t count) {
+    uint64_t pos;
+    if (rb->flags & RING_FLAG_OVERWRITE) {
+        if (count > 0) {
+            overwrite_enqueue(rb, events, count);
+        }
+        return count;
+    }
+    size_t n = ring_claim_range(&rb->tail, rb->buffer, rb->mask, SLOT_LAG_PRODUCER, count, &pos);
+    if (n == 0) {
+        return 0; // Lleno: 'pos' no está definido
+    }
+    latency_stamp(rb, pos, n);
+    ring_publish_range(rb->buffer, rb->capacity, pos, events, n);
+    wake_consumers(rb, n);
+    return n;
+}
+
+// --- DEQUEUE POR LOTES (Consumidor) ---
+// Extrae hasta 'max' eventos con un solo CAS sobre la cabeza.
+// Solo reclama ranuras ya publicadas, así que nunca espera a un productor.
+// Retorna el número de eventos extraídos (0 si el buffer está vacío).
+size_t dequeue_events(AtomicEventRingBuffer *rb, Event *events, size_t max) {
+    uint64_t pos;
+    if (rb->flags & RING_FLAG_OVERWRITE) {
+        // Evento a evento: cada uno se valida contra su sello por separado.
+        size_t n = 0;
+        while (n < max && overwrite_dequeue(rb, &events[n], NULL, NULL) == 0) {
+            n++;
+        }
+        if (n > 0) {
+            wake_producers(rb, n);
+        }
+        return n;
+    }
+    size_t n = ring_claim_range(&rb->head, rb->buffer, rb->mask, SLOT_LAG_CONSUMER, max, &pos);
+    if (n == 0) {
+        return 0; // Vacío: 'pos' no está definido
+    }
+    // Antes de liberar: después las ranuras (y sus sellos) son de los productores.
+    latency_record(rb, pos, n);
+    ring_release_range(rb->buffer, rb->capacity, pos, events, n);
+    wake_producers(rb, n);
+    return n;
+}
+
+// --- OCUPACIÓN ---
+// Se lee 'head' antes que 'tail': ambos solo crecen y head nunca adelanta a tail,
+// así que la resta no puede ser negativa. Puede quedar desfasada si otros hilos
+// avanzan entre las dos lecturas, por eso se acota a la capacidad.
+uint64_t ring_buffer_size(AtomicEventRingBuffer *rb) {
+    uint64_t head = atomic_load_explicit(&rb->head, memory_order_acquire);
+    uint64_t tail = atomic_load_explicit(&rb->tail, memory_order_acquire);
+    uint64_t size = tail - head;
+    return size > rb->capacity ? rb->capacity : size;
+}
+
+// --- EXPORTAR LA LATENCIA ---
+int ring_latency_snapshot(AtomicEventRingBuffer *rb, RingLatencyHistogram *out) {
+    if (!(rb->flags & RING_FLAG_LATENCY)) {
+        return -1;
+    }
+    memset(out, 0, sizeof(*out));
+    const RingLatencyHistogram *table = ring_latency_table(rb);
+    uint64_t count = 0, sum = 0, max = 0;
+    for (size_t i = 0; i < RING_LATENCY_MAX_CONSUMERS; i++) {
+        const RingLatencyHistogram *h = &table[i];
+        if (atomic_load_explicit(&h->owner, memory_order_relaxed) == 0) {
+            continue;
+        }
+        // 'count' antes que los buckets: el consumidor lo actualiza después que ellos, así
+        // que el total exportado no supera lo que suman los buckets copiados.
+        uint64_t h_count = atomic_load_explicit(&h->count, memory_order_relaxed);
+        for (size_t b = 0; b < RING_LATENCY_BUCKETS; b++) {
+            ring_counter_add(&out->buckets[b], atomic_load_explicit(&h->buckets[b], memory_order_relaxed));
+        }
+        count += h_count;
+        sum += atomic_load_explicit(&h->sum_ns, memory_order_relaxed);
+        uint64_t h_max = atomic_load_explicit(&h->max_ns, memory_order_relaxed);
+        max = h_max > max ? h_max : max;
+    }
+    atomic_store_explicit(&out->count, count, memory_order_relaxed);
+    atomic_store_explicit(&out->sum_ns, sum, memory_order_relaxed);
+    atomic_store_explicit(&out->max_ns, max, memory_order_relaxed);
+    return 0;
+}
+
+uint64_t ring_latency_bucket_floor(size_t bucket) {
+    if (bucket < 2 * RING_LATENCY_SUB_BUCKETS) {
+        return bucket;
+    }
+    unsigned shift = (unsigned)(bucket / RING_LATENCY_SUB_BUCKETS) - 1;
+    uint64_t sub = bucket % RING_LATENCY_SUB_BUCKETS + RING_LATENCY_SUB_BUCKETS;
+    return sub << shift;
+}
+
+uint64_t ring_latency_percentile(const RingLatencyHistogram *h, double p) {
+    uint64_t count = atomic_load_explicit(&h->count, memory_order_relaxed);
+    uint64_t max = atomic_load_explicit(&h->max_ns, memory_order_relaxed);
+    if (count == 0) {
+        return 0;
+    }
+    uint64_t rank = (uint64_t)(p * (double)count + 0.5);
+    rank = rank < 1 ? 1 : rank > count ? count : rank;
+
+    uint64_t seen = 0;
+    for (size_t b = 0; b < RING_LATENCY_BUCKETS; b++) {
+        seen += atomic_load_explicit(&h->buckets[b], memory_order_relaxed);
+        if (seen >= rank) {
+            uint64_t upper = b + 1 < RING_LATENCY_BUCKETS ? ring_latency_bucket_floor(b + 1) - 1 : UINT64_MAX;
+            return upper < max ? upper : max;
+        }
+    }
+    return max;
+}
+
+// --- CONTADORES DE CONTENCIÓN ---
+#ifdef RING_STATS
+_Thread_local RingStatsBlock *ring_stats_tls;
+static _Atomic(RingStatsBlock *) ring_stats_list;
+
+// Primer uso en un hilo: reserva su bloque (nunca se libera, para no perder sus totales
+// al terminar el hilo) y lo enlaza en la lista. Es el único RMW compartido, uno por hilo.
+RingStatsBlock *ring_stats_register(void) {
+    RingStatsBlock *block = ring_alloc(sizeof(RingStatsBlock));
+    if (block == NULL) {
+        abort(); // No hay forma de contar sin bloque: solo pasa en compilaciones de diagnóstico
+    }
+    memset(block, 0, sizeof(*block));
+    block->next = atomic_load_explicit(&ring_stats_list, memory_order_relaxed);
+    while (!atomic_compare_exchange_weak_explicit(&ring_stats_list, &block->next, block,
+                                                  memory_order_release, memory_order_relaxed)) {
+    }
+    ring_stats_tls = block;
+    return block;
+}
+#endif
+
+int ring_stats_snapshot(RingStats *out) {
+    memset(out, 0, sizeof(*out));
+#ifdef RING_STATS
+    for (RingStatsBlock *b = atomic_load_explicit(&ring_stats_list, memory_order_acquire); b != NULL; b = b->next) {
+        out->enqueue_ok += atomic_load_explicit(&b->enqueue_ok, memory_order_relaxed);
+        out->enqueue_full += atomic_load_explicit(&b->enqueue_full, memory_order_relaxed);
+        out->tail_cas_failures += atomic_load_explicit(&b->tail_cas_failures, memory_order_relaxed);
+        out->dequeue_ok += atomic_load_explicit(&b->dequeue_ok, memory_order_relaxed);
+        out->dequeue_empty += atomic_load_explicit(&b->dequeue_empty, memory_order_relaxed);
+        out->head_cas_failures += atomic_load_explicit(&b->head_cas_failures, memory_order_relaxed);
+        out->wait_spins += atomic_load_explicit(&b->wait_spins, memory_order_relaxed);
+        out->wait_parks += atomic_load_explicit(&b->wait_parks, memory_order_relaxed);
+    }
+    return 0;
+#else
+    return -1;
+#endif
+}
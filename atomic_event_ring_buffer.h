@@ -0,0 +1,296 @@
+#ifndef ATOMIC_EVENT_RING_BUFFER_H
+#define ATOMIC_EVENT_RING_BUFFER_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// --- CONFIGURACIÓN DEL RING BUFFER ---
+// La capacidad se elige en ring_buffer_create() y se redondea a potencia de dos,
+// de modo que los índices se calculan con una máscara en lugar de un módulo.
+#define RING_MAX_CAPACITY (1ULL << 32)
+
+// --- CABECERA DE LAYOUT ---
+// Identifica un ring en memoria compartida: otro proceso (quizá otro binario) solo se
+// engancha si coinciden la firma, la versión y los tamaños. Hay que subir
+// RING_LAYOUT_VERSION con cualquier cambio en AtomicEventRingBuffer o EventSlot.
+#define RING_LAYOUT_MAGIC 0x41455242u // "AERB"
+#define RING_LAYOUT_VERSION 6u
+
+// Valores de AtomicEventRingBuffer.flags
+#define RING_FLAG_SHARED 0x1u  // Vive en memoria compartida entre procesos
+#define RING_FLAG_LATENCY 0x2u // Mide la latencia enqueue->dequeue (ver RingLatencyHistogram)
+#define RING_FLAG_OVERWRITE 0x4u // Con el ring lleno se sobrescribe el evento más antiguo
+// Los pone ring_buffer_create_alloc según lo que consiguió (no se piden en 'flags'):
+#define RING_FLAG_MAPPED 0x8u   // Reserva con mmap propio (se libera con munmap)
+#define RING_FLAG_HUGETLB 0x10u // En huge pages reservadas (MAP_HUGETLB)
+#define RING_FLAG_THP 0x20u     // En transparent huge pages (madvise MADV_HUGEPAGE)
+// Para evitar false sharing, alinear los punteros head y tail, y el buffer mismo.
+// Un tamaño típico de línea de caché es 64 bytes.
+#define CACHE_LINE_SIZE 64
+
+// --- PRAGMAS PARA ALINEACIÓN (GCC/Clang) ---
+#if defined(__GNUC__) || defined(__clang__)
+#define ALIGNED(x) __attribute__ ((aligned(x)))
+#else
+#define ALIGNED(x)
+#endif
+
+// --- ESTRUCTURA DEL EVENTO (PARA VMM) ---
+// Representa un evento de alto rendimiento, como una falla de página en un VMM.
+typedef struct {
+    uint32_t pid; // Process ID del guest que generó el evento
+    uint32_t vpn; // Virtual Page Number asociado al evento
+    // Un event_id podría ser (PID << 32) | index para unicidad y trazabilidad.
+} Event;
+
+// --- RANURA DEL RING BUFFER ---
+// Cada ranura lleva su propio sello de secuencia (protocolo de Vyukov):
+//   sequence == pos            -> libre, el productor de la posición 'pos' puede escribir.
+//   sequence == pos + 1        -> publicada, el consumidor de 'pos' puede leer.
+//   sequence == pos + capacity -> liberada, lista para la siguiente vuelta.
+// La publicación es por ranura: un consumidor nunca ve un evento a medio escribir.
+typedef struct {
+    atomic_uint_least64_t sequence;
+    Event event;
+} EventSlot;
+
+// --- POLÍTICA DE ESPERA ---
+// Cómo esperan enqueue_event_wait/dequeue_event_wait: spin con PAUSE durante un
+// presupuesto que se adapta entre 'spin_min' y 'spin_max' (crece cuando el spin llega
+// a tiempo, decrece cuando no), y después duermen en un futex si 'park' es distinto de 0.
+// Con 'park' a 0 nunca duermen: tras el spin ceden la CPU con sched_yield.
+typedef struct {
+    uint32_t spin_min;     // Presupuesto mínimo de spin (iteraciones); al menos 1 si hay spin
+    uint32_t spin_max;     // Presupuesto máximo; 0 desactiva el spin
+    uint32_t spin_initial; // Presupuesto de partida
+    uint32_t park;         // Dormir en el futex tras el spin (1) o solo ceder la CPU (0)
+} RingWaitPolicy;
+
+#define RING_WAIT_POLICY_DEFAULT ((RingWaitPolicy){ .spin_min = 16, .spin_max = 8192, .spin_initial = 256, .park = 1 })
+
+// --- COLA DE ESPERA ---
+// Un lado del ring (productores o consumidores) esperando al otro, en un futex o en un
+// eventfd armado. El lado opuesto lee 'waiters' y 'armed' en cada operación, así que
+// esa línea solo se escribe cuando alguien va a dormir o arma el eventfd.
+typedef struct {
+    ALIGNED(CACHE_LINE_SIZE) atomic_uint_least32_t waiters; // Hilos registrados para dormir
+    atomic_uint_least32_t futex;                            // Palabra futex: cambia en cada despertar
+    atomic_uint_least32_t armed;                            // Hay que señalizar 'eventfd' en la próxima cesión
+    int32_t eventfd;                                        // -1 si no hay eventfd (descriptor local al proceso)
+
+    // Solo la usa este lado. El presupuesto cambia a menudo mientras se espera y, en la
+    // línea anterior, cada cambio invalidaría la copia de todos los hilos del otro lado.
+    ALIGNED(CACHE_LINE_SIZE) atomic_uint_least32_t spin; // Presupuesto de spin adaptativo actual
+} RingWaitQueue;
+
+// --- HISTOGRAMA DE LATENCIA ---
+// Log-lineal al estilo HDR: valores por debajo de 2 * RING_LATENCY_SUB_BUCKETS ns van a
+// su propio bucket; a partir de ahí cada potencia de dos se parte en
+// RING_LATENCY_SUB_BUCKETS buckets iguales (error relativo < 1/32, ~3%), hasta 2^64 ns.
+// Cada consumidor escribe en el suyo sin RMW (un solo escritor: load + store relaxed),
+// y cualquiera puede leerlos a la vez para combinarlos con ring_latency_snapshot.
+#define RING_LATENCY_SUB_BITS 5
+#define RING_LATENCY_SUB_BUCKETS (1u << RING_LATENCY_SUB_BITS)
+#define RING_LATENCY_BUCKETS ((64 - RING_LATENCY_SUB_BITS + 1) * RING_LATENCY_SUB_BUCKETS)
+// Consumidores (hilos) vivos a la vez con histograma propio en un ring; los demás no se
+// miden. La entrada de un hilo que terminó la hereda el siguiente consumidor nuevo.
+#define RING_LATENCY_MAX_CONSUMERS 16
+
+typedef struct {
+    ALIGNED(CACHE_LINE_SIZE) atomic_uint_least32_t owner; // TID del consumidor; 0 = libre
+    atomic_uint_least64_t count;                          // Eventos medidos
+    atomic_uint_least64_t sum_ns;                         // Suma de latencias (para la media)
+    atomic_uint_least64_t max_ns;                         // Latencia máxima exacta
+    atomic_uint_least64_t buckets[RING_LATENCY_BUCKETS];
+} RingLatencyHistogram;
+
+// --- ESTRUCTURA DEL RING BUFFER MPMC (Lock-Free) ---
+typedef struct {
+    // Posiciones atómicas para la cabeza y la cola.
+    // Son contadores libres de 64 bits: nunca se reducen módulo la capacidad, solo se
+    // enmascaran al indexar 'buffer'. Así cada evento tiene un número de secuencia global
+    // único (su posición), las 'capacity' ranuras son utilizables (lleno es
+    // tail - head == capacity) y un sello nunca se repite: no hay ventana ABA mientras el
+    // contador no dé la vuelta (2^64 eventos, siglos a mil millones de eventos por segundo).
+    // Solo se usan para reclamar posiciones; la sincronización de datos va por ranura.
+    // Alineados para prevenir false sharing.
+    ALIGNED(CACHE_LINE_SIZE) atomic_uint_least64_t head; // Próxima posición para DEQUEUE
+    atomic_uint_least64_t lost; // RING_FLAG_OVERWRITE: eventos saltados por los consumidores
+    ALIGNED(CACHE_LINE_SIZE) atomic_uint_least64_t tail; // Próxima posición para ENQUEUE
+
+    // Cabecera de layout y geometría, de solo lectura tras la creación. En su propia
+    // línea para que las escrituras en head/tail no invaliden la copia que leen todos.
+    // No hay punteros en todo el ring: en memoria compartida funciona igual aunque cada
+    // proceso lo mapee en una dirección distinta.
+    ALIGNED(CACHE_LINE_SIZE) atomic_uint_least32_t magic; // RING_LAYOUT_MAGIC; se escribe la última
+    uint32_t version;                           // RING_LAYOUT_VERSION
+    uint32_t header_size;                       // sizeof(AtomicEventRingBuffer)
+    uint32_t slot_size;                         // sizeof(EventSlot)
+    uint32_t flags;                             // RING_FLAG_*
+    uint64_t capacity;                          // Número de ranuras (potencia de dos)
+    uint64_t mask;                              // capacity - 1
+    uint64_t map_bytes;                         // RING_FLAG_MAPPED: longitud del mmap, para munmap
+    RingWaitPolicy wait_policy;                 // Solo cambia con ring_buffer_set_wait_policy
+
+    // Espera bloqueante, una cola por lado (cada una en su propia línea).
+    RingWaitQueue consumer_wait; // Consumidores esperando eventos (dequeue_event_wait)
+    RingWaitQueue producer_wait; // Productores esperando ranuras libres (enqueue_event_wait)
+
+    // Las ranuras del buffer, reservadas junto a la cabecera. También alineadas.
+    // Con RING_FLAG_LATENCY les siguen, en la misma reserva, un sello de tiempo por
+    // ranura (uint64_t[capacity]) y la tabla de histogramas de los consumidores.
+    ALIGNED(CACHE_LINE_SIZE) EventSlot buffer[];
+} AtomicEventRingBuffer;
+
+// Crea un ring con al menos 'capacity' ranuras (redondeado a potencia de dos, mínimo 2).
+// Retorna NULL si la capacidad es 0, supera RING_MAX_CAPACITY o falla la reserva.
+AtomicEventRingBuffer *ring_buffer_create(uint64_t capacity);
+// Como ring_buffer_create con opciones RING_FLAG_* (RING_FLAG_LATENCY, RING_FLAG_OVERWRITE).
+// Retorna NULL también si 'flags' contiene una opción desconocida o ambas a la vez.
+AtomicEventRingBuffer *ring_buffer_create_ex(uint64_t capacity, uint32_t flags);
+
+// --- POLÍTICA DE RESERVA ---
+// Para rings grandes (1M ranuras = 16 MiB de ranuras) en hosts NUMA. Con páginas de
+// 4 KiB cada evento toca una entrada de TLB distinta y el ring cae en el nodo que le
+// tocara al primer hilo que lo escribe. ring_buffer_create_alloc reserva con mmap:
+//   huge_pages: MAP_HUGETLB; si no hay huge pages reservadas, una región alineada con
+//               MADV_HUGEPAGE (THP); si THP está desactivado, páginas normales.
+//               El resultado queda en rb->flags (RING_FLAG_HUGETLB / RING_FLAG_THP).
+//   numa_node:  mbind(MPOL_PREFERRED) al nodo; RING_NUMA_LOCAL es el nodo de la CPU
+//               del hilo que crea el ring (crearlo desde el consumidor lo deja en su
+//               nodo) y es solo una preferencia: si el mbind falla, el ring se crea
+//               igual. RING_NUMA_ANY no hace mbind.
+//   populate:   todas las páginas se asignan al crear (MAP_POPULATE, o
+//               MADV_POPULATE_WRITE tras el mbind) y los primeros eventos no fallan página.
+#define RING_NUMA_LOCAL (-1)
+#define RING_NUMA_ANY (-2)
+
+typedef struct {
+    uint32_t huge_pages; // Intentar huge pages (1) o no (0)
+    uint32_t populate;   // Prefault de todas las páginas al crear (1) o no (0)
+    int32_t numa_node;   // Nodo >= 0, RING_NUMA_LOCAL o RING_NUMA_ANY
+} RingAllocPolicy;
+
+#define RING_ALLOC_POLICY_DEFAULT ((RingAllocPolicy){ .huge_pages = 1, .populate = 1, .numa_node = RING_NUMA_LOCAL })
+
+// Como ring_buffer_create_ex, reservando según 'alloc' (NULL: RING_ALLOC_POLICY_DEFAULT).
+// Retorna NULL con errno si falla el mmap o el mbind a un nodo explícito; la falta de
+// huge pages no es un error y, al salir bien, errno queda como estaba. Solo rings
+// locales: el segmento compartido lo reserva shm.
+AtomicEventRingBuffer *ring_buffer_create_alloc(uint64_t capacity, uint32_t flags, const RingAllocPolicy *alloc);
+// Libera un ring de ring_buffer_create(_ex/_alloc), o desmapea uno compartido en este proceso.
+void ring_buffer_destroy(AtomicEventRingBuffer *rb);
+
+// --- RING EN MEMORIA COMPARTIDA ---
+// ring_buffer_create_shared crea el objeto POSIX shm 'name' (p. ej. "/vmm-faults"), que
+// no debe existir, y mapea en él cabecera y ranuras. ring_buffer_attach lo mapea desde
+// otro proceso tras validar la cabecera de layout. Después, cada evento cuesta lo mismo
+// que en un ring local: ninguna syscall salvo despertar a quien duerma en un futex.
+// Retornan NULL con errno: EINVAL (capacidad, o layout incompatible al enganchar),
+// EAGAIN (el creador aún no terminó de inicializarlo) o el de shm_open/mmap.
+AtomicEventRingBuffer *ring_buffer_create_shared(const char *name, uint64_t capacity);
+AtomicEventRingBuffer *ring_buffer_create_shared_ex(const char *name, uint64_t capacity, uint32_t flags);
+AtomicEventRingBuffer *ring_buffer_attach(const char *name);
+// Borra el nombre; el ring sigue vivo hasta que todos los procesos lo desmapeen.
+int ring_buffer_unlink_shared(const char *name);
+
+int enqueue_event(AtomicEventRingBuffer *rb, const Event *event);
+int dequeue_event(AtomicEventRingBuffer *rb, Event *event);
+// Como enqueue_event/dequeue_event, pero esperan a que haya una ranura libre/un evento
+// según la política de espera del ring: spin con PAUSE y después futex.
+// Así, con el ring lleno, los productores se frenan en lugar de perder eventos.
+// 'timeout_ns' < 0 espera sin límite; 0 solo hace la fase de spin.
+// Retornan 0 en éxito, -1 si vence el timeout.
+int enqueue_event_wait(AtomicEventRingBuffer *rb, const Event *event, int64_t timeout_ns);
+int dequeue_event_wait(AtomicEventRingBuffer *rb, Event *event, int64_t timeout_ns);
+// Cambia la política de espera (por defecto RING_WAIT_POLICY_DEFAULT).
+// Debe llamarse antes de que haya hilos esperando en el ring.
+void ring_buffer_set_wait_policy(AtomicEventRingBuffer *rb, const RingWaitPolicy *policy);
+// Igual que enqueue_event/dequeue_event, y además devuelven en '*seq' (si no es NULL)
+// la posición del evento: su número de secuencia global en este ring.
+int enqueue_event_seq(AtomicEventRingBuffer *rb, const Event *event, uint64_t *seq);
+int dequeue_event_seq(AtomicEventRingBuffer *rb, Event *event, uint64_t *seq);
+size_t enqueue_events(AtomicEventRingBuffer *rb, const Event *events, size_t count);
+size_t dequeue_events(AtomicEventRingBuffer *rb, Event *events, size_t max);
+// API sin copia: el productor escribe el evento directamente en la ranura entre
+// ring_claim y ring_commit; el consumidor lo lee (o modifica) entre ring_peek y
+// ring_release. ring_claim/ring_peek retornan NULL si el buffer está lleno/vacío.
+Event *ring_claim(AtomicEventRingBuffer *rb);
+void ring_commit(AtomicEventRingBuffer *rb, Event *event);
+Event *ring_peek(AtomicEventRingBuffer *rb);
+void ring_release(AtomicEventRingBuffer *rb, Event *event);
+// --- NOTIFICACIÓN POR EVENTFD ---
+// Para consumidores que multiplexan el ring en un bucle epoll junto a otros descriptores.
+// ring_buffer_enable_eventfd crea (una vez) el eventfd del ring y lo retorna para
+// registrarlo con EPOLLIN; -1 con errno si falla o si el ring es compartido (el
+// descriptor solo vale en este proceso).
+// Los productores solo escriben en él cuando un consumidor lo ha armado, así que bajo
+// carga sostenida no hay despertares extra. Bucle típico del consumidor:
+//     al recibir EPOLLIN: ring_eventfd_ack(rb);
+//     do { while (dequeue_event(rb, &ev) == 0) procesar(&ev); } while (ring_eventfd_arm(rb) != 0);
+//     volver a epoll_wait
+// ring_eventfd_arm retorna 0 si quedó armado (el ring está vacío y se puede dormir en
+// epoll) o 1 si hay eventos en curso y hay que seguir vaciando.
+int ring_buffer_enable_eventfd(AtomicEventRingBuffer *rb);
+int ring_eventfd_arm(AtomicEventRingBuffer *rb);
+// Pone a cero el contador del eventfd tras un despertar de epoll.
+void ring_eventfd_ack(AtomicEventRingBuffer *rb);
+
+// --- LATENCIA EXTREMO A EXTREMO ---
+// Con RING_FLAG_LATENCY, cada enqueue sella la ranura con CLOCK_MONOTONIC y cada dequeue
+// (también por lotes, peek y las variantes _wait) suma 'ahora - sello' al histograma del
+// hilo consumidor en este ring, que se asigna solo en su primer dequeue. Sin atómicos
+// extra: el sello viaja con la publicación de la ranura. En un ring compartido la tabla
+// vive en el segmento, así que cualquier proceso enganchado puede exportarla.
+// ring_latency_snapshot combina todos los histogramas en '*out' (lectura concurrente,
+// sin parar a los consumidores). Retorna 0, o -1 si el ring no mide latencia.
+int ring_latency_snapshot(AtomicEventRingBuffer *rb, RingLatencyHistogram *out);
+// Valor más pequeño que cae en el bucket 'bucket' (ns).
+uint64_t ring_latency_bucket_floor(size_t bucket);
+// Latencia (ns) por debajo de la cual queda la fracción 'p' (0..1) de los eventos:
+// el límite superior de su bucket, acotado por max_ns. 0 si el histograma está vacío.
+uint64_t ring_latency_percentile(const RingLatencyHistogram *h, double p);
+
+// --- CONTADORES DE CONTENCIÓN ---
+// Solo con -DRING_STATS (make STATS=1): cada hilo cuenta en su propio bloque, en su
+// propia línea de caché, sin atómicos compartidos. Se cuenta en el lado contendido de
+// todos los rings (ambos lados del MPMC, productores del MPSC, consumidores del SPMC).
+// Los bloques de hilos que ya terminaron se conservan, así que los totales son del
+// proceso desde que arrancó.
+typedef struct {
+    uint64_t enqueue_ok;        // Eventos reclamados por productores
+    uint64_t enqueue_full;      // Intentos de encolar con el ring lleno
+    uint64_t tail_cas_failures; // CAS fallidos sobre 'tail' (productores compitiendo)
+    uint64_t dequeue_ok;        // Eventos reclamados por consumidores
+    uint64_t dequeue_empty;     // Intentos de extraer con el ring vacío
+    uint64_t head_cas_failures; // CAS fallidos sobre 'head' (consumidores compitiendo)
+    uint64_t wait_spins;        // Iteraciones de spin en enqueue_event_wait/dequeue_event_wait
+    uint64_t wait_parks;        // Veces que esas esperas durmieron en el futex
+} RingStats;
+
+// Suma los bloques de todos los hilos en '*out' (lectura concurrente, sin parar a nadie).
+// Retorna 0, o -1 (con '*out' a cero) si la biblioteca se compiló sin RING_STATS.
+int ring_stats_snapshot(RingStats *out);
+
+// --- MODO SOBRESCRITURA (RING_FLAG_OVERWRITE) ---
+// Para telemetría en la que importan los datos más nuevos (semántica del ring de
+// ftrace/perf). Los productores nunca fallan: reclaman su posición con un fetch_add y,
+// si el ring está lleno, sobrescriben la ranura del evento más antiguo. Cada ranura se
+// escribe como un seqlock (sello impar mientras se escribe), así que un consumidor
+// nunca devuelve un evento a medio sobrescribir. Si un consumidor descubre por el sello
+// que los productores le adelantaron una vuelta, salta al evento más antiguo que sigue
+// en el ring y cuenta los que se perdieron.
+// Funcionan enqueue_event(_seq), enqueue_events, enqueue_event_wait (nunca espera),
+// dequeue_event(_seq), dequeue_events y dequeue_event_wait; ring_claim y ring_peek
+// retornan NULL, porque la ranura podría sobrescribirse mientras se usa.
+// dequeue_event_lossy es dequeue_event que además devuelve en '*lost' cuántos eventos
+// se saltó este consumidor justo antes del devuelto (0 sin pérdidas o en modo normal).
+int dequeue_event_lossy(AtomicEventRingBuffer *rb, Event *event, uint64_t *lost);
+// Total de eventos perdidos en el ring desde su creación (0 en modo normal).
+uint64_t ring_buffer_lost(AtomicEventRingBuffer *rb);
+
+// Número aproximado de eventos reclamados por productores y aún no por consumidores.
+uint64_t ring_buffer_size(AtomicEventRingBuffer *rb);
+
+#endif // ATOMIC_EVENT_RING_BUFFER_H
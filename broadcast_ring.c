@@ -0,0 +1,193 @@
+#define _GNU_SOURCE // syscall() del futex en ring_internal.h
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "broadcast_ring.h"
+#include "ring_internal.h"
+
+// --- CREACIÓN / DESTRUCCIÓN ---
+BroadcastRingBuffer *broadcast_ring_create(uint64_t capacity, uint32_t detach_laggards) {
+    capacity = ring_normalize_capacity(capacity);
+    if (capacity == 0) {
+        return NULL;
+    }
+
+    BroadcastRingBuffer *rb = ring_alloc(sizeof(BroadcastRingBuffer) + capacity * sizeof(EventSlot));
+    if (rb == NULL) {
+        return NULL;
+    }
+    rb->capacity = capacity;
+    rb->mask = capacity - 1;
+    rb->detach_laggards = detach_laggards;
+    atomic_store_explicit(&rb->tail, 0, memory_order_relaxed);
+    atomic_store_explicit(&rb->gate, 0, memory_order_relaxed);
+    atomic_store_explicit(&rb->epoch, 0, memory_order_relaxed);
+    for (int i = 0; i < BROADCAST_MAX_CONSUMERS; i++) {
+        atomic_store_explicit(&rb->cursors[i].cursor, 0, memory_order_relaxed);
+        atomic_store_explicit(&rb->cursors[i].state, BROADCAST_CURSOR_FREE, memory_order_relaxed);
+    }
+    // Sello 0: ninguna posición publicada todavía (ver ring_seqlock_publish).
+    for (uint64_t i = 0; i < capacity; i++) {
+        atomic_store_explicit(&rb->buffer[i].sequence, 0, memory_order_relaxed);
+    }
+    atomic_thread_fence(memory_order_release);
+    ring_log("Ring Buffer broadcast: Inicializado (%" PRIu64 " ranuras).\n", capacity);
+    return rb;
+}
+
+void broadcast_ring_destroy(BroadcastRingBuffer *rb) {
+    free(rb);
+}
+
+// --- SUSCRIPCIÓN ---
+// El cursor nuevo se fija con 'tail' leído después de subir 'epoch'. Un recálculo de
+// 'gate' que no vio la entrada enganchada leyó los demás cursores antes de esa subida
+// (si no, se repite), así que su mínimo no pasa de ese 'tail': ningún productor
+// sobrescribe una ranura que este consumidor aún no ha leído.
+int broadcast_ring_subscribe(BroadcastRingBuffer *rb) {
+    for (int i = 0; i < BROADCAST_MAX_CONSUMERS; i++) {
+        BroadcastCursor *cur = &rb->cursors[i];
+        uint32_t expected = BROADCAST_CURSOR_FREE;
+        if (!atomic_compare_exchange_strong_explicit(&cur->state, &expected, BROADCAST_CURSOR_CLAIMED,
+                                                     memory_order_acquire, memory_order_relaxed)) {
+            continue;
+        }
+        // Un valor provisional válido antes de que los productores empiecen a contarlo.
+        atomic_store_explicit(&cur->cursor, atomic_load_explicit(&rb->tail, memory_order_relaxed),
+                              memory_order_relaxed);
+        atomic_store_explicit(&cur->state, BROADCAST_CURSOR_ATTACHED, memory_order_seq_cst);
+        atomic_fetch_add_explicit(&rb->epoch, 1, memory_order_seq_cst);
+        atomic_store_explicit(&cur->cursor, atomic_load_explicit(&rb->tail, memory_order_seq_cst),
+                              memory_order_release);
+        return i;
+    }
+    return -1;
+}
+
+void broadcast_ring_unsubscribe(BroadcastRingBuffer *rb, int id) {
+    atomic_store_explicit(&rb->cursors[id].state, BROADCAST_CURSOR_FREE, memory_order_release);
+}
+
+void broadcast_ring_detach(BroadcastRingBuffer *rb, int id) {
+    uint32_t expected = BROADCAST_CURSOR_ATTACHED;
+    atomic_compare_exchange_strong_explicit(&rb->cursors[id].state, &expected, BROADCAST_CURSOR_DETACHED,
+                                            memory_order_seq_cst, memory_order_relaxed);
+}
+
+// --- PRODUCTORES ---
+// Recalcula 'gate': el cursor enganchado más atrasado, o 'pos' si no hay ninguno.
+// Deja en '*slowest' su índice (-1 sin consumidores).
+static uint64_t broadcast_refresh_gate(BroadcastRingBuffer *rb, uint64_t pos, int *slowest) {
+    uint64_t min;
+    uint32_t epoch;
+    do {
+        epoch = atomic_load_explicit(&rb->epoch, memory_order_seq_cst);
+        min = pos;
+        *slowest = -1;
+        for (int i = 0; i < BROADCAST_MAX_CONSUMERS; i++) {
+            BroadcastCursor *cur = &rb->cursors[i];
+            if (atomic_load_explicit(&cur->state, memory_order_seq_cst) != BROADCAST_CURSOR_ATTACHED) {
+                continue;
+            }
+            // acquire: empareja con el store-release del cursor, así que el consumidor
+            // terminó de leer las ranuras que deja atrás antes de que se reutilicen.
+            uint64_t c = atomic_load_explicit(&cur->cursor, memory_order_acquire);
+            if ((int64_t)(c - min) < 0) {
+                min = c;
+                *slowest = i;
+            }
+        }
+    } while (atomic_load_explicit(&rb->epoch, memory_order_seq_cst) != epoch);
+    atomic_store_explicit(&rb->gate, min, memory_order_release);
+    return min;
+}
+
+// Ranuras que se pueden reclamar desde 'pos' según 'gate'.
+static inline uint64_t broadcast_free_slots(BroadcastRingBuffer *rb, uint64_t pos, uint64_t gate) {
+    int64_t used = (int64_t)(pos - gate);
+    if (used < 0) {
+        used = 0; // 'gate' recalculado después de leer 'tail'
+    }
+    return (uint64_t)used >= rb->capacity ? 0 : rb->capacity - (uint64_t)used;
+}
+
+int broadcast_enqueue_event(BroadcastRingBuffer *rb, const Event *event) {
+    return broadcast_enqueue_events(rb, event, 1) == 1 ? 0 : -1;
+}
+
+size_t broadcast_enqueue_events(BroadcastRingBuffer *rb, const Event *events, size_t count) {
+    if (count == 0) {
+        return 0;
+    }
+    uint64_t pos = atomic_load_explicit(&rb->tail, memory_order_relaxed);
+    uint64_t n;
+
+    for (;;) {
+        uint64_t free_slots = broadcast_free_slots(rb, pos, atomic_load_explicit(&rb->gate, memory_order_acquire));
+        if (free_slots < count) {
+            // Solo se recorren los cursores cuando la copia de 'gate' no da sitio.
+            int slowest;
+            free_slots = broadcast_free_slots(rb, pos, broadcast_refresh_gate(rb, pos, &slowest));
+            if (free_slots == 0) {
+                if (rb->detach_laggards && slowest >= 0) {
+                    broadcast_ring_detach(rb, slowest); // Va una vuelta entera por detrás
+                    continue;
+                }
+                cpu_relax();
+                return 0; // Lleno
+            }
+        }
+        n = count < free_slots ? count : free_slots;
+        if (atomic_compare_exchange_weak_explicit(&rb->tail, &pos, pos + n,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    for (uint64_t i = 0; i < n; i++) {
+        ring_seqlock_publish(&rb->buffer[(pos + i) & rb->mask], pos + i, &events[i]);
+    }
+    return (size_t)n;
+}
+
+// --- CONSUMIDORES ---
+int broadcast_dequeue_event(BroadcastRingBuffer *rb, int id, Event *event) {
+    BroadcastCursor *cur = &rb->cursors[id];
+    if (atomic_load_explicit(&cur->state, memory_order_acquire) != BROADCAST_CURSOR_ATTACHED) {
+        return BROADCAST_DETACHED;
+    }
+
+    uint64_t pos = atomic_load_explicit(&cur->cursor, memory_order_relaxed);
+    EventSlot *slot = &rb->buffer[pos & rb->mask];
+    uint64_t published = 2 * (pos + 1);
+    uint64_t seq = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+
+    if (seq == published) {
+        Event copy = slot->event;
+        // Seqlock: si el sello no cambió durante la copia, la copia es íntegra.
+        atomic_thread_fence(memory_order_acquire);
+        seq = atomic_load_explicit(&slot->sequence, memory_order_relaxed);
+        if (seq == published) {
+            *event = copy;
+            // release: la lectura termina antes de que los productores vean la ranura libre.
+            atomic_store_explicit(&cur->cursor, pos + 1, memory_order_release);
+            return 0;
+        }
+    }
+    if (seq > published) {
+        // Sobrescrita: solo le pasa a un consumidor que ya no frena a los productores.
+        broadcast_ring_detach(rb, id);
+        return BROADCAST_DETACHED;
+    }
+    cpu_relax();
+    return -1; // Nada nuevo (o su productor aún está escribiendo)
+}
+
+uint64_t broadcast_ring_lag(BroadcastRingBuffer *rb, int id) {
+    uint64_t tail = atomic_load_explicit(&rb->tail, memory_order_relaxed);
+    uint64_t cursor = atomic_load_explicit(&rb->cursors[id].cursor, memory_order_relaxed);
+    return (int64_t)(tail - cursor) > 0 ? tail - cursor : 0;
+}
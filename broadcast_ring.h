@@ -0,0 +1,83 @@
+#ifndef BROADCAST_RING_H
+#define BROADCAST_RING_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "atomic_event_ring_buffer.h"
+
+// --- RING DE DIFUSIÓN (BroadcastRingBuffer) ---
+// Cada evento se publica una vez y lo ven todos los consumidores suscritos (el
+// rastreador de migraciones, el balloon driver y el auditor), en vez de un ring por
+// suscriptor. Cada consumidor avanza su propio cursor, en su propia línea de caché;
+// una ranura solo se reutiliza cuando el cursor más lento la ha pasado.
+// Productores: CAS sobre 'tail', como el MPMC, pero "lleno" lo decide el cursor más
+// lento (cacheado en 'gate' y recalculado solo cuando, según él, no hay sitio).
+// Ranuras con sellos seqlock (2 * pos + 1 escribiendo, 2 * (pos + 1) publicada): un
+// consumidor desenganchado que aún estaba leyendo detecta que le sobrescribieron la
+// ranura en vez de devolver un evento mezclado.
+
+#define BROADCAST_MAX_CONSUMERS 16
+
+// Retorno de broadcast_dequeue_event para un consumidor desenganchado.
+#define BROADCAST_DETACHED (-2)
+
+// Valores de BroadcastCursor.state
+#define BROADCAST_CURSOR_FREE 0u     // Entrada sin usar
+#define BROADCAST_CURSOR_CLAIMED 1u  // Suscribiéndose: los productores aún no la cuentan
+#define BROADCAST_CURSOR_ATTACHED 2u // Frena a los productores
+#define BROADCAST_CURSOR_DETACHED 3u // Desenganchado: ya no frena; su dueño debe darlo de baja
+
+typedef struct {
+    // Solo lo escribe su consumidor; los productores lo leen al recalcular 'gate'.
+    ALIGNED(CACHE_LINE_SIZE) atomic_uint_least64_t cursor; // Próxima posición a leer
+    atomic_uint_least32_t state;                           // BROADCAST_CURSOR_*
+} BroadcastCursor;
+
+typedef struct {
+    ALIGNED(CACHE_LINE_SIZE) atomic_uint_least64_t tail; // Próxima posición para ENQUEUE
+    // Mínimo de los cursores enganchados según el último recálculo (puede quedarse
+    // atrás, nunca adelantarse). 'epoch' cambia en cada suscripción: un recálculo que
+    // la cruza se repite, porque pudo no ver el cursor nuevo.
+    ALIGNED(CACHE_LINE_SIZE) atomic_uint_least64_t gate;
+    atomic_uint_least32_t epoch;
+
+    ALIGNED(CACHE_LINE_SIZE) uint64_t capacity;
+    uint64_t mask;
+    uint32_t detach_laggards; // Con el ring lleno, desenganchar al más lento en vez de fallar
+
+    BroadcastCursor cursors[BROADCAST_MAX_CONSUMERS];
+
+    ALIGNED(CACHE_LINE_SIZE) EventSlot buffer[];
+} BroadcastRingBuffer;
+
+// Crea un ring de al menos 'capacity' ranuras (misma regla que ring_buffer_create).
+// Con 'detach_laggards' distinto de 0, un productor que encuentra el ring lleno
+// desengancha al consumidor más lento (que va una vuelta entera por detrás) y sigue;
+// con 0, el enqueue falla como en un ring lleno normal.
+BroadcastRingBuffer *broadcast_ring_create(uint64_t capacity, uint32_t detach_laggards);
+void broadcast_ring_destroy(BroadcastRingBuffer *rb);
+
+// Suscribe un consumidor y retorna su índice (< BROADCAST_MAX_CONSUMERS), o -1 si no
+// quedan entradas. Empieza en el siguiente evento publicado: no ve los anteriores.
+int broadcast_ring_subscribe(BroadcastRingBuffer *rb);
+// Da de baja al consumidor 'id' (lo llama su dueño, también tras BROADCAST_DETACHED).
+void broadcast_ring_unsubscribe(BroadcastRingBuffer *rb, int id);
+// Desengancha a 'id' desde cualquier hilo: deja de frenar a los productores y su
+// siguiente dequeue retorna BROADCAST_DETACHED.
+void broadcast_ring_detach(BroadcastRingBuffer *rb, int id);
+
+// Publica una vez para todos los suscriptores. Igual que enqueue_event/enqueue_events:
+// 0/-1 y número de eventos añadidos. Sin suscriptores los eventos se descartan.
+int broadcast_enqueue_event(BroadcastRingBuffer *rb, const Event *event);
+size_t broadcast_enqueue_events(BroadcastRingBuffer *rb, const Event *events, size_t count);
+
+// Siguiente evento para el consumidor 'id' (un solo hilo por 'id'). Retorna 0, -1 si no
+// hay eventos nuevos, o BROADCAST_DETACHED.
+int broadcast_dequeue_event(BroadcastRingBuffer *rb, int id, Event *event);
+
+// Eventos publicados o en curso que 'id' aún no ha leído (lectura barata, aproximada).
+uint64_t broadcast_ring_lag(BroadcastRingBuffer *rb, int id);
+
+#endif // BROADCAST_RING_H
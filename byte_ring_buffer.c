@@ -0,0 +1,137 @@
+#define _GNU_SOURCE // syscall() del futex en ring_internal.h
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "byte_ring_buffer.h"
+#include "ring_internal.h"
+
+static inline uint64_t record_bytes(uint32_t length) {
+    return sizeof(ByteRecordHeader) + (((uint64_t)length + BYTE_RECORD_ALIGN - 1) & ~(uint64_t)(BYTE_RECORD_ALIGN - 1));
+}
+
+// --- CREACIÓN / DESTRUCCIÓN ---
+ByteRingBuffer *byte_ring_create(uint64_t size) {
+    if (size == 0 || size > RING_MAX_CAPACITY) {
+        return NULL;
+    }
+    size = size < CACHE_LINE_SIZE ? CACHE_LINE_SIZE : round_up_pow2(size);
+
+    ByteRingBuffer *rb = ring_alloc(sizeof(ByteRingBuffer) + size);
+    if (rb == NULL) {
+        return NULL;
+    }
+    rb->size = size;
+    rb->mask = size - 1;
+    uint64_t max_record = size / 2 - sizeof(ByteRecordHeader);
+    rb->max_record = max_record > BYTE_RECORD_LENGTH_MASK ? BYTE_RECORD_LENGTH_MASK : (uint32_t)max_record;
+    rb->read = 0;
+    atomic_store_explicit(&rb->head, 0, memory_order_relaxed);
+    atomic_store_explicit(&rb->tail, 0, memory_order_relaxed);
+    memset(rb->data, 0, size); // Todo el espacio libre a cero: ninguna cabecera publicada
+    atomic_thread_fence(memory_order_release);
+    ring_log("Ring Buffer de bytes: Inicializado (%" PRIu64 " bytes).\n", size);
+    return rb;
+}
+
+void byte_ring_destroy(ByteRingBuffer *rb) {
+    free(rb);
+}
+
+// --- PRODUCTOR ---
+void *byte_ring_reserve(ByteRingBuffer *rb, uint32_t length) {
+    if (length > rb->max_record) {
+        return NULL;
+    }
+    uint64_t total = record_bytes(length);
+    uint64_t tail = atomic_load_explicit(&rb->tail, memory_order_relaxed);
+    uint64_t pad;
+
+    for (;;) {
+        // Si el registro no cabe antes del final del array, se rellena hasta allí.
+        uint64_t room = rb->size - (tail & rb->mask);
+        pad = room < total ? room : 0;
+        // acquire: si el consumidor ya liberó hasta 'head', esos bytes se ven a cero.
+        uint64_t head = atomic_load_explicit(&rb->head, memory_order_acquire);
+        if (tail + pad + total - head > rb->size) {
+            cpu_relax();
+            return NULL; // Lleno
+        }
+        if (atomic_compare_exchange_weak_explicit(&rb->tail, &tail, tail + pad + total,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    if (pad > 0) {
+        // El relleno se publica en el acto: no lleva carga útil que esperar.
+        ByteRecordHeader *marker = (ByteRecordHeader *)&rb->data[tail & rb->mask];
+        atomic_store_explicit(&marker->state, BYTE_RECORD_COMMITTED | BYTE_RECORD_PAD | (uint32_t)pad,
+                              memory_order_release);
+    }
+    ByteRecordHeader *header = (ByteRecordHeader *)&rb->data[(tail + pad) & rb->mask];
+    header->length = length;
+    return header + 1;
+}
+
+// release: la carga útil es visible antes que la cabecera publicada.
+void byte_ring_commit(ByteRingBuffer *rb, void *payload) {
+    (void)rb;
+    ByteRecordHeader *header = (ByteRecordHeader *)payload - 1;
+    atomic_store_explicit(&header->state, BYTE_RECORD_COMMITTED | header->length, memory_order_release);
+}
+
+int byte_ring_write(ByteRingBuffer *rb, const void *payload, uint32_t length) {
+    void *dst = byte_ring_reserve(rb, length);
+    if (dst == NULL) {
+        return -1;
+    }
+    memcpy(dst, payload, length);
+    byte_ring_commit(rb, dst);
+    return 0;
+}
+
+// --- CONSUMIDOR ---
+// Más allá de lo reservado el espacio está a cero, así que una cabecera sin publicar
+// (0) significa igual "vacío" que "el productor aún escribe": no hace falta leer 'tail'.
+// La excepción es un ring lleno recorrido entero: 'read' ha dado la vuelta y apunta a la
+// cabecera (publicada) del primer registro sin liberar, así que se corta por 'head'.
+const void *byte_ring_next(ByteRingBuffer *rb, uint32_t *length) {
+    uint64_t head = atomic_load_explicit(&rb->head, memory_order_relaxed); // Solo lo escribe el consumidor
+    for (;;) {
+        if (rb->read - head == rb->size) {
+            return NULL; // Todo recorrido: falta byte_ring_release
+        }
+        ByteRecordHeader *header = (ByteRecordHeader *)&rb->data[rb->read & rb->mask];
+        uint32_t state = atomic_load_explicit(&header->state, memory_order_acquire);
+        if (!(state & BYTE_RECORD_COMMITTED)) {
+            return NULL;
+        }
+        if (state & BYTE_RECORD_PAD) {
+            rb->read += state & BYTE_RECORD_LENGTH_MASK; // Al principio del array
+            continue;
+        }
+        uint32_t n = state & BYTE_RECORD_LENGTH_MASK;
+        rb->read += record_bytes(n);
+        *length = n;
+        return header + 1;
+    }
+}
+
+// Pone a cero [head, read) (en dos tramos si da la vuelta) y después lo cede con
+// release: un productor que vea el nuevo 'head' ve también los ceros.
+void byte_ring_release(ByteRingBuffer *rb) {
+    uint64_t head = atomic_load_explicit(&rb->head, memory_order_relaxed);
+    uint64_t n = rb->read - head;
+    if (n == 0) {
+        return;
+    }
+    uint64_t start = head & rb->mask;
+    uint64_t first = n < rb->size - start ? n : rb->size - start;
+    memset(&rb->data[start], 0, first);
+    memset(&rb->data[0], 0, n - first);
+    atomic_store_explicit(&rb->head, rb->read, memory_order_release);
+}
@@ -0,0 +1,76 @@
+#ifndef BYTE_RING_BUFFER_H
+#define BYTE_RING_BUFFER_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "atomic_event_ring_buffer.h"
+
+// --- RING DE REGISTROS DE LONGITUD VARIABLE ---
+// Para eventos con carga útil (salidas MMIO, descriptores virtio...): en lugar de
+// ranuras de tamaño fijo, un array de bytes con registros prefijados por su longitud y
+// alineados a 8 bytes. Un evento pequeño ocupa solo lo que mide.
+// Varios productores, un solo consumidor (como el MPSC):
+//  - Los productores reservan bytes con un CAS sobre 'tail', escriben la carga útil en
+//    el sitio y la publican con byte_ring_commit.
+//  - El consumidor recorre los registros publicados sin copiarlos (byte_ring_next) y
+//    devuelve de una vez todo lo recorrido con byte_ring_release.
+// Un registro que no cabe antes del final del array deja un marcador de relleno y
+// empieza en la siguiente vuelta: un registro nunca se parte en dos.
+//
+// Sin sellos: el consumidor sabe si un registro está publicado solo por su cabecera.
+// Para que eso sea fiable, todo el espacio libre está a cero: byte_ring_release pone a
+// cero los bytes que devuelve antes de cederlos. El consumidor nunca lee 'tail'.
+
+// Cabecera de cada registro (8 bytes; la carga útil empieza justo detrás).
+typedef struct {
+    atomic_uint_least32_t state; // 0 = sin publicar; BYTE_RECORD_COMMITTED | longitud
+    uint32_t length;             // Longitud de la carga útil (la escribe el productor al reservar)
+} ByteRecordHeader;
+
+#define BYTE_RECORD_COMMITTED 0x80000000u // Registro publicado
+#define BYTE_RECORD_PAD 0x40000000u       // Relleno hasta el final del array: saltar
+#define BYTE_RECORD_LENGTH_MASK 0x3fffffffu
+#define BYTE_RECORD_ALIGN 8
+
+typedef struct {
+    // Línea del consumidor que leen los productores para ver el espacio libre; solo se
+    // escribe en byte_ring_release.
+    ALIGNED(CACHE_LINE_SIZE) atomic_uint_least64_t head;
+    // Línea de los productores.
+    ALIGNED(CACHE_LINE_SIZE) atomic_uint_least64_t tail;
+    // Privada del consumidor: hasta dónde ha recorrido sin liberar todavía.
+    ALIGNED(CACHE_LINE_SIZE) uint64_t read;
+
+    ALIGNED(CACHE_LINE_SIZE) uint64_t size; // Bytes del array (potencia de dos)
+    uint64_t mask;                          // size - 1
+    uint32_t max_record;                    // Carga útil máxima de un registro
+
+    ALIGNED(CACHE_LINE_SIZE) uint8_t data[];
+} ByteRingBuffer;
+
+// Crea un ring de al menos 'size' bytes (potencia de dos, mínimo 64). La carga útil
+// máxima es size / 2 - 8: así un registro siempre cabe, con relleno incluido, en un
+// ring vacío. Retorna NULL si 'size' supera RING_MAX_CAPACITY o falla la reserva.
+ByteRingBuffer *byte_ring_create(uint64_t size);
+void byte_ring_destroy(ByteRingBuffer *rb);
+
+// --- PRODUCTOR ---
+// Reserva un registro de 'length' bytes y devuelve dónde escribir la carga útil
+// (alineada a 8). Retorna NULL si no hay espacio o 'length' supera max_record.
+// Hasta byte_ring_commit el consumidor no pasa de este registro: la ventana debe ser corta.
+void *byte_ring_reserve(ByteRingBuffer *rb, uint32_t length);
+void byte_ring_commit(ByteRingBuffer *rb, void *payload);
+// reserve + memcpy + commit. Retorna 0, o -1 si no hay espacio.
+int byte_ring_write(ByteRingBuffer *rb, const void *payload, uint32_t length);
+
+// --- CONSUMIDOR (uno solo) ---
+// Siguiente registro publicado, en la memoria del ring, y su longitud en '*length'.
+// Retorna NULL si no hay más (vacío, o el siguiente aún no está publicado).
+// Los registros devueltos siguen siendo válidos hasta byte_ring_release.
+const void *byte_ring_next(ByteRingBuffer *rb, uint32_t *length);
+// Devuelve a los productores todos los registros recorridos con byte_ring_next.
+void byte_ring_release(ByteRingBuffer *rb);
+
+#endif // BYTE_RING_BUFFER_H
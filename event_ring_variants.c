@@ -0,0 +1,275 @@
+#define _GNU_SOURCE // syscall() del futex en ring_internal.h
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "event_ring_variants.h"
+#include "ring_internal.h"
+
+// ============================================================================
+// SPSC
+// ============================================================================
+
+SpscEventRingBuffer *spsc_ring_buffer_create(uint64_t capacity) {
+    capacity = ring_normalize_capacity(capacity);
+    if (capacity == 0) {
+        return NULL;
+    }
+
+    SpscEventRingBuffer *rb = ring_alloc(sizeof(SpscEventRingBuffer) + capacity * sizeof(Event));
+    if (rb == NULL) {
+        return NULL;
+    }
+    rb->capacity = capacity;
+    rb->mask = capacity - 1;
+    rb->cached_head = 0;
+    rb->cached_tail = 0;
+    atomic_store_explicit(&rb->head, 0, memory_order_relaxed);
+    atomic_store_explicit(&rb->tail, 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    ring_log("Ring Buffer SPSC: Inicializado (%" PRIu64 " ranuras).\n", capacity);
+    return rb;
+}
+
+void spsc_ring_buffer_destroy(SpscEventRingBuffer *rb) {
+    free(rb);
+}
+
+// Copia [pos, pos + n) en dos tramos memcpy (antes y después de dar la vuelta).
+static inline void spsc_copy_in(SpscEventRingBuffer *rb, uint64_t pos, const Event *events, size_t n) {
+    size_t start = pos & rb->mask;
+    size_t first = n < rb->capacity - start ? n : rb->capacity - start;
+    memcpy(&rb->buffer[start], events, first * sizeof(Event));
+    memcpy(&rb->buffer[0], events + first, (n - first) * sizeof(Event));
+}
+
+static inline void spsc_copy_out(SpscEventRingBuffer *rb, uint64_t pos, Event *events, size_t n) {
+    size_t start = pos & rb->mask;
+    size_t first = n < rb->capacity - start ? n : rb->capacity - start;
+    memcpy(events, &rb->buffer[start], first * sizeof(Event));
+    memcpy(events + first, &rb->buffer[0], (n - first) * sizeof(Event));
+}
+
+int spsc_enqueue_event(SpscEventRingBuffer *rb, const Event *event) {
+    uint64_t tail = atomic_load_explicit(&rb->tail, memory_order_relaxed);
+
+    // Solo se toca la línea del consumidor cuando la copia privada dice "lleno".
+    if (tail - rb->cached_head == rb->capacity) {
+        rb->cached_head = atomic_load_explicit(&rb->head, memory_order_acquire);
+        if (tail - rb->cached_head == rb->capacity) {
+            cpu_relax();
+            return -1; // Lleno
+        }
+    }
+
+    rb->buffer[tail & rb->mask] = *event;
+    // release: el evento es visible antes que la nueva cola.
+    atomic_store_explicit(&rb->tail, tail + 1, memory_order_release);
+    return 0;
+}
+
+int spsc_dequeue_event(SpscEventRingBuffer *rb, Event *event) {
+    uint64_t head = atomic_load_explicit(&rb->head, memory_order_relaxed);
+
+    // Solo se toca la línea del productor cuando la copia privada dice "vacío".
+    if (head == rb->cached_tail) {
+        rb->cached_tail = atomic_load_explicit(&rb->tail, memory_order_acquire);
+        if (head == rb->cached_tail) {
+            cpu_relax();
+            return -1; // Vacío
+        }
+    }
+
+    *event = rb->buffer[head & rb->mask];
+    // release: la lectura termina antes de que el productor vea la ranura libre.
+    atomic_store_explicit(&rb->head, head + 1, memory_order_release);
+    return 0;
+}
+
+size_t spsc_enqueue_events(SpscEventRingBuffer *rb, const Event *events, size_t count) {
+    uint64_t tail = atomic_load_explicit(&rb->tail, memory_order_relaxed);
+    uint64_t free_slots = rb->capacity - (tail - rb->cached_head);
+
+    if (free_slots < count) {
+        rb->cached_head = atomic_load_explicit(&rb->head, memory_order_acquire);
+        free_slots = rb->capacity - (tail - rb->cached_head);
+        if (free_slots == 0) {
+            cpu_relax();
+            return 0; // Lleno
+        }
+    }
+
+    size_t n = count < free_slots ? count : (size_t)free_slots;
+    spsc_copy_in(rb, tail, events, n);
+    atomic_store_explicit(&rb->tail, tail + n, memory_order_release);
+    return n;
+}
+
+size_t spsc_dequeue_events(SpscEventRingBuffer *rb, Event *events, size_t max) {
+    uint64_t head = atomic_load_explicit(&rb->head, memory_order_relaxed);
+    uint64_t ready = rb->cached_tail - head;
+
+    if (ready < max) {
+        rb->cached_tail = atomic_load_explicit(&rb->tail, memory_order_acquire);
+        ready = rb->cached_tail - head;
+        if (ready == 0) {
+            cpu_relax();
+            return 0; // Vacío
+        }
+    }
+
+    size_t n = max < ready ? max : (size_t)ready;
+    spsc_copy_out(rb, head, events, n);
+    atomic_store_explicit(&rb->head, head + n, memory_order_release);
+    return n;
+}
+
+// ============================================================================
+// MPSC
+// ============================================================================
+
+MpscEventRingBuffer *mpsc_ring_buffer_create(uint64_t capacity) {
+    capacity = ring_normalize_capacity(capacity);
+    if (capacity == 0) {
+        return NULL;
+    }
+
+    MpscEventRingBuffer *rb = ring_alloc(sizeof(MpscEventRingBuffer) + capacity * sizeof(EventSlot));
+    if (rb == NULL) {
+        return NULL;
+    }
+    rb->capacity = capacity;
+    rb->mask = capacity - 1;
+    rb->head = 0;
+    atomic_store_explicit(&rb->tail, 0, memory_order_relaxed);
+    ring_init_slots(rb->buffer, capacity);
+    atomic_thread_fence(memory_order_release);
+    ring_log("Ring Buffer MPSC: Inicializado (%" PRIu64 " ranuras).\n", capacity);
+    return rb;
+}
+
+void mpsc_ring_buffer_destroy(MpscEventRingBuffer *rb) {
+    free(rb);
+}
+
+int mpsc_enqueue_event(MpscEventRingBuffer *rb, const Event *event) {
+    uint64_t pos;
+    EventSlot *slot = ring_claim_slot(&rb->tail, rb->buffer, rb->mask, SLOT_LAG_PRODUCER, &pos);
+    if (slot == NULL) {
+        return -1; // Lleno
+    }
+    slot->event = *event;
+    atomic_store_explicit(&slot->sequence, pos + 1, memory_order_release);
+    return 0;
+}
+
+int mpsc_dequeue_event(MpscEventRingBuffer *rb, Event *event) {
+    uint64_t pos = rb->head;
+    EventSlot *slot = &rb->buffer[pos & rb->mask];
+
+    // Único consumidor: basta con que la ranura esté publicada, sin CAS.
+    if (atomic_load_explicit(&slot->sequence, memory_order_acquire) != pos + 1) {
+        cpu_relax();
+        return -1; // Vacío
+    }
+    *event = slot->event;
+    atomic_store_explicit(&slot->sequence, pos + rb->capacity, memory_order_release);
+    rb->head = pos + 1;
+    return 0;
+}
+
+size_t mpsc_enqueue_events(MpscEventRingBuffer *rb, const Event *events, size_t count) {
+    uint64_t pos;
+    size_t n = ring_claim_range(&rb->tail, rb->buffer, rb->mask, SLOT_LAG_PRODUCER, count, &pos);
+    ring_publish_range(rb->buffer, rb->capacity, pos, events, n);
+    return n;
+}
+
+size_t mpsc_dequeue_events(MpscEventRingBuffer *rb, Event *events, size_t max) {
+    uint64_t pos = rb->head;
+    size_t n = ring_count_ready(rb->buffer, rb->mask, pos, SLOT_LAG_CONSUMER, max);
+    if (n == 0) {
+        cpu_relax();
+        return 0; // Vacío
+    }
+    ring_release_range(rb->buffer, rb->capacity, pos, events, n);
+    rb->head = pos + n;
+    return n;
+}
+
+// ============================================================================
+// SPMC
+// ============================================================================
+
+SpmcEventRingBuffer *spmc_ring_buffer_create(uint64_t capacity) {
+    capacity = ring_normalize_capacity(capacity);
+    if (capacity == 0) {
+        return NULL;
+    }
+
+    SpmcEventRingBuffer *rb = ring_alloc(sizeof(SpmcEventRingBuffer) + capacity * sizeof(EventSlot));
+    if (rb == NULL) {
+        return NULL;
+    }
+    rb->capacity = capacity;
+    rb->mask = capacity - 1;
+    rb->tail = 0;
+    atomic_store_explicit(&rb->head, 0, memory_order_relaxed);
+    ring_init_slots(rb->buffer, capacity);
+    atomic_thread_fence(memory_order_release);
+    ring_log("Ring Buffer SPMC: Inicializado (%" PRIu64 " ranuras).\n", capacity);
+    return rb;
+}
+
+void spmc_ring_buffer_destroy(SpmcEventRingBuffer *rb) {
+    free(rb);
+}
+
+int spmc_enqueue_event(SpmcEventRingBuffer *rb, const Event *event) {
+    uint64_t pos = rb->tail;
+    EventSlot *slot = &rb->buffer[pos & rb->mask];
+
+    // Único productor: basta con que la ranura esté libre, sin CAS.
+    if (atomic_load_explicit(&slot->sequence, memory_order_acquire) != pos) {
+        cpu_relax();
+        return -1; // Lleno
+    }
+    slot->event = *event;
+    atomic_store_explicit(&slot->sequence, pos + 1, memory_order_release);
+    rb->tail = pos + 1;
+    return 0;
+}
+
+int spmc_dequeue_event(SpmcEventRingBuffer *rb, Event *event) {
+    uint64_t pos;
+    EventSlot *slot = ring_claim_slot(&rb->head, rb->buffer, rb->mask, SLOT_LAG_CONSUMER, &pos);
+    if (slot == NULL) {
+        return -1; // Vacío
+    }
+    *event = slot->event;
+    atomic_store_explicit(&slot->sequence, pos + rb->capacity, memory_order_release);
+    return 0;
+}
+
+size_t spmc_enqueue_events(SpmcEventRingBuffer *rb, const Event *events, size_t count) {
+    uint64_t pos = rb->tail;
+    size_t n = ring_count_ready(rb->buffer, rb->mask, pos, SLOT_LAG_PRODUCER, count);
+    if (n == 0) {
+        cpu_relax();
+        return 0; // Lleno
+    }
+    ring_publish_range(rb->buffer, rb->capacity, pos, events, n);
+    rb->tail = pos + n;
+    return n;
+}
+
+size_t spmc_dequeue_events(SpmcEventRingBuffer *rb, Event *events, size_t max) {
+    uint64_t pos;
+    size_t n = ring_claim_range(&rb->head, rb->buffer, rb->mask, SLOT_LAG_CONSUMER, max, &pos);
+    ring_release_range(rb->buffer, rb->capacity, pos, events, n);
+    return n;
+}
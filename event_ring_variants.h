@@ -0,0 +1,82 @@
+#ifndef EVENT_RING_VARIANTS_H
+#define EVENT_RING_VARIANTS_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "atomic_event_ring_buffer.h"
+
+// --- VARIANTES ESPECIALIZADAS DEL RING ---
+// Mismo Event y misma forma de API que AtomicEventRingBuffer
+// (create/destroy, enqueue/dequeue, lotes), con el prefijo spsc_/mpsc_/spmc_.
+// Los lados con un único hilo no usan CAS; el lado con varios hilos usa un solo CAS.
+// Devuelven lo mismo que la versión MPMC: 0/-1 por evento, número de eventos por lote.
+
+// --- SPSC: un productor, un consumidor ---
+// Solo load-acquire/store-release. Cada lado guarda una copia privada de la posición
+// del otro y solo la relee cuando, según esa copia, el ring está lleno/vacío.
+typedef struct {
+    // Línea del consumidor: escribe 'head', lee 'tail' solo al refrescar su copia.
+    ALIGNED(CACHE_LINE_SIZE) atomic_uint_least64_t head;
+    uint64_t cached_tail; // Copia privada del consumidor
+
+    // Línea del productor: escribe 'tail', lee 'head' solo al refrescar su copia.
+    ALIGNED(CACHE_LINE_SIZE) atomic_uint_least64_t tail;
+    uint64_t cached_head; // Copia privada del productor
+
+    ALIGNED(CACHE_LINE_SIZE) uint64_t capacity;
+    uint64_t mask;
+
+    // Sin sellos por ranura: la publicación es el store-release de 'tail'.
+    ALIGNED(CACHE_LINE_SIZE) Event buffer[];
+} SpscEventRingBuffer;
+
+SpscEventRingBuffer *spsc_ring_buffer_create(uint64_t capacity);
+void spsc_ring_buffer_destroy(SpscEventRingBuffer *rb);
+int spsc_enqueue_event(SpscEventRingBuffer *rb, const Event *event);
+int spsc_dequeue_event(SpscEventRingBuffer *rb, Event *event);
+size_t spsc_enqueue_events(SpscEventRingBuffer *rb, const Event *events, size_t count);
+size_t spsc_dequeue_events(SpscEventRingBuffer *rb, Event *events, size_t max);
+
+// --- MPSC: varios productores, un consumidor ---
+// Productores: protocolo por ranura con un CAS sobre 'tail', igual que el MPMC.
+// Consumidor: avanza su 'head' privado sin atómicos; solo mira el sello de la ranura.
+typedef struct {
+    ALIGNED(CACHE_LINE_SIZE) uint64_t head; // Privado del consumidor
+    ALIGNED(CACHE_LINE_SIZE) atomic_uint_least64_t tail;
+
+    ALIGNED(CACHE_LINE_SIZE) uint64_t capacity;
+    uint64_t mask;
+
+    ALIGNED(CACHE_LINE_SIZE) EventSlot buffer[];
+} MpscEventRingBuffer;
+
+MpscEventRingBuffer *mpsc_ring_buffer_create(uint64_t capacity);
+void mpsc_ring_buffer_destroy(MpscEventRingBuffer *rb);
+int mpsc_enqueue_event(MpscEventRingBuffer *rb, const Event *event);
+int mpsc_dequeue_event(MpscEventRingBuffer *rb, Event *event);
+size_t mpsc_enqueue_events(MpscEventRingBuffer *rb, const Event *events, size_t count);
+size_t mpsc_dequeue_events(MpscEventRingBuffer *rb, Event *events, size_t max);
+
+// --- SPMC: un productor, varios consumidores ---
+// Productor: avanza su 'tail' privado sin atómicos; solo mira el sello de la ranura.
+// Consumidores: protocolo por ranura con un CAS sobre 'head', igual que el MPMC.
+typedef struct {
+    ALIGNED(CACHE_LINE_SIZE) atomic_uint_least64_t head;
+    ALIGNED(CACHE_LINE_SIZE) uint64_t tail; // Privado del productor
+
+    ALIGNED(CACHE_LINE_SIZE) uint64_t capacity;
+    uint64_t mask;
+
+    ALIGNED(CACHE_LINE_SIZE) EventSlot buffer[];
+} SpmcEventRingBuffer;
+
+SpmcEventRingBuffer *spmc_ring_buffer_create(uint64_t capacity);
+void spmc_ring_buffer_destroy(SpmcEventRingBuffer *rb);
+int spmc_enqueue_event(SpmcEventRingBuffer *rb, const Event *event);
+int spmc_dequeue_event(SpmcEventRingBuffer *rb, Event *event);
+size_t spmc_enqueue_events(SpmcEventRingBuffer *rb, const Event *events, size_t count);
+size_t spmc_dequeue_events(SpmcEventRingBuffer *rb, Event *events, size_t max);
+
+#endif // EVENT_RING_VARIANTS_H
@@ -0,0 +1,123 @@
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fault_coalescer.h"
+
+// --- CREACIÓN / DESTRUCCIÓN ---
+// Bits de una tabla de al menos 2 * n entradas (potencia de dos): carga <= 1/2, sondeos cortos.
+static uint32_t table_bits(size_t n) {
+    uint32_t bits = 1;
+    while ((1ULL << bits) < 2 * (uint64_t)n) {
+        bits++;
+    }
+    return bits;
+}
+
+FaultCoalescer *fault_coalescer_create(size_t batch) {
+    if (batch == 0 || batch > (1u << 31)) {
+        return NULL;
+    }
+    uint32_t bits = table_bits(batch);
+
+    FaultCoalescer *c = calloc(1, sizeof(FaultCoalescer));
+    if (c == NULL) {
+        return NULL;
+    }
+    c->batch = batch;
+    c->shift = 64 - bits;
+    c->mask = (1ULL << bits) - 1;
+    c->scratch = malloc(batch * sizeof(Event));
+    // calloc: época 0 en todas las entradas, y el primer lote usa la época 1.
+    c->table = calloc(c->mask + 1, sizeof(FaultCoalescerEntry));
+    if (c->scratch == NULL || c->table == NULL) {
+        fault_coalescer_destroy(c);
+        return NULL;
+    }
+    return c;
+}
+
+void fault_coalescer_destroy(FaultCoalescer *c) {
+    free(c->scratch);
+    free(c->table);
+    free(c);
+}
+
+// --- COALESCENCIA ---
+static inline uint64_t fault_key(const Event *event) {
+    return ((uint64_t)event->pid << 32) | event->vpn;
+}
+
+// Un lote de como mucho (mask + 1) / 2 eventos: la tabla está dimensionada para eso.
+static size_t coalesce_batch(FaultCoalescer *c, const Event *events, size_t n, CoalescedFault *out) {
+    // Nueva época: invalida todo el lote anterior sin tocar la tabla. Solo al dar la
+    // vuelta el contador (cada 2^32 lotes) hay que borrarla de verdad.
+    if (++c->epoch == 0) {
+        memset(c->table, 0, (c->mask + 1) * sizeof(FaultCoalescerEntry));
+        c->epoch = 1;
+    }
+
+    size_t unique = 0;
+    for (size_t i = 0; i < n; i++) {
+        uint64_t key = fault_key(&events[i]);
+        // Hash multiplicativo (Fibonacci): los bits altos mezclan pid y vpn.
+        uint64_t slot = (key * 0x9E3779B97F4A7C15ULL) >> c->shift;
+
+        for (;;) {
+            FaultCoalescerEntry *e = &c->table[slot];
+            if (e->epoch != c->epoch) {
+                // Libre en este lote: primera aparición.
+                e->key = key;
+                e->epoch = c->epoch;
+                e->index = (uint32_t)unique;
+                out[unique].event = events[i];
+                out[unique].count = 1;
+                unique++;
+                break;
+            }
+            if (e->key == key) {
+                out[e->index].count++;
+                break;
+            }
+            slot = (slot + 1) & c->mask; // Sondeo lineal
+        }
+    }
+
+    c->events_in += n;
+    c->faults_out += unique;
+    return unique;
+}
+
+// Agranda la tabla para un lote de 'n' eventos. La tabla nueva empieza vacía (época 0).
+static int grow_table(FaultCoalescer *c, size_t n) {
+    if (n > (1u << 31)) {
+        errno = EINVAL; // 'index' es de 32 bits
+        return -1;
+    }
+    uint32_t bits = table_bits(n);
+    FaultCoalescerEntry *table = calloc(1ULL << bits, sizeof(FaultCoalescerEntry));
+    if (table == NULL) {
+        return -1; // errno = ENOMEM
+    }
+    free(c->table);
+    c->table = table;
+    c->shift = 64 - bits;
+    c->mask = (1ULL << bits) - 1;
+    c->epoch = 0;
+    return 0;
+}
+
+size_t fault_coalesce(FaultCoalescer *c, const Event *events, size_t n, CoalescedFault *out) {
+    // Todo en un lote, para que un fallo repetido salga una sola vez aunque 'n' > batch.
+    if (2 * (uint64_t)n > c->mask + 1 && grow_table(c, n) != 0) {
+        return 0;
+    }
+    return coalesce_batch(c, events, n, out);
+}
+
+size_t fault_coalesce_ring(FaultCoalescer *c, AtomicEventRingBuffer *rb, CoalescedFault *out) {
+    size_t n = dequeue_events(rb, c->scratch, c->batch);
+    return n > 0 ? coalesce_batch(c, c->scratch, n, out) : 0;
+}
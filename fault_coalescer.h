@@ -0,0 +1,53 @@
+#ifndef FAULT_COALESCER_H
+#define FAULT_COALESCER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "atomic_event_ring_buffer.h"
+
+// --- ETAPA DE COALESCENCIA DE FALLOS DE PÁGINA ---
+// Etapa opcional del consumidor: extrae un lote del ring y agrupa los eventos repetidos
+// por (pid, vpn), de modo que cinco fallos de la misma página se atienden una sola vez.
+// Usa un conjunto hash de direccionamiento abierto dimensionado para el lote (carga
+// <= 1/2; crece si fault_coalesce recibe más) que no se borra entre lotes: cada entrada
+// lleva la época del lote que la escribió. Un coalescedor pertenece a un solo hilo
+// consumidor.
+
+// Un fallo único del lote y cuántas veces apareció.
+typedef struct {
+    Event event;    // Primera aparición (el orden de salida es el de primera aparición)
+    uint32_t count; // Repeticiones en el lote, >= 1
+} CoalescedFault;
+
+typedef struct {
+    uint64_t key;   // (pid << 32) | vpn
+    uint32_t epoch; // Lote que escribió la entrada; otra época = libre
+    uint32_t index; // Posición en la salida
+} FaultCoalescerEntry;
+
+typedef struct {
+    size_t batch;               // Máximo de eventos por lote
+    uint32_t epoch;             // Lote actual
+    uint32_t shift;             // 64 - log2(tamaño de la tabla), para el hash multiplicativo
+    uint64_t mask;              // Tamaño de la tabla - 1
+    uint64_t events_in;         // Eventos leídos desde la creación
+    uint64_t faults_out;        // Fallos únicos emitidos desde la creación
+    Event *scratch;             // Lote extraído del ring
+    FaultCoalescerEntry *table;
+} FaultCoalescer;
+
+// Crea un coalescedor para lotes de hasta 'batch' eventos. NULL si 'batch' es 0
+// (o excede 2^31) o falla la reserva.
+FaultCoalescer *fault_coalescer_create(size_t batch);
+void fault_coalescer_destroy(FaultCoalescer *c);
+
+// Agrupa 'n' eventos en 'out' (espacio para 'n'). Retorna los fallos únicos. Con
+// 'n' > batch la tabla crece (y se queda así) para agrupar los 'n' en un solo lote;
+// si no puede crecer retorna 0 con errno = ENOMEM (EINVAL si 'n' excede 2^31).
+size_t fault_coalesce(FaultCoalescer *c, const Event *events, size_t n, CoalescedFault *out);
+// Extrae hasta 'batch' eventos de 'rb' con dequeue_events y los agrupa en 'out'
+// (espacio para 'batch'). Retorna los fallos únicos (0 si el ring estaba vacío).
+size_t fault_coalesce_ring(FaultCoalescer *c, AtomicEventRingBuffer *rb, CoalescedFault *out);
+
+#endif // FAULT_COALESCER_H
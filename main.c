@@ -1,23 +1,915 @@
+#define _DEFAULT_SOURCE // Para usleep con -std=c11
 #include <stdatomic.h>
+#include <inttypes.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <syslog.h>
 #include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
 #include <pthread.h>
+#include <sched.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
 #include <time.h>
 
 // Incluir tu Ring Buffer
-#include "atomic_event_ring_buffer.c"
+#include "atomic_event_ring_buffer.h"
+#include "broadcast_ring.h"
+#include "byte_ring_buffer.h"
+#include "event_ring_variants.h"
+#include "fault_coalescer.h"
+#include "priority_ring.h"
+#include "ring_pipeline.h"
+#include "ring_set.h"
 
 #define NUM_PRODUCERS 8       // Más productores para saturar
 #define NUM_CONSUMERS 2       // Menos consumidores para desbalance
-#define EVENTS_PER_PRODUCER 500000 // Medio millón por productor
+#define EVENTS_PER_PRODUCER 50000 // Sin pérdidas: todos los eventos pasan por el consumidor lento
 #define CONSUMER_DELAY_US 10  // Retraso para simular VMM lento
+#define RING_CAPACITY 1024    // Ranuras del ring
+#define CONSUMER_WAIT_NS 1000000 // Espera máxima por evento antes de revisar si acabaron los productores
+
+static AtomicEventRingBuffer *global_ring_buffer;
 
 // Contadores globales para verificación
 atomic_int total_produced = 0;
 atomic_int total_consumed = 0;
+atomic_int producers_finished = 0; // Los consumidores terminan cuando todos los productores acabaron
+
+// --- PRUEBAS FUNCIONALES ---
+// Casos concretos de cada subsistema, antes del test de estrés. Un fallo se informa
+// con su línea y hace que el programa termine con FAILURE.
+static int checks_failed = 0;
+
+#define CHECK(cond)                                                                \
+    do {                                                                           \
+        if (!(cond)) {                                                             \
+            fprintf(stderr, "CHECK fallido (%s:%d): %s\n", __FILE__, __LINE__, #cond); \
+            checks_failed++;                                                       \
+        }                                                                          \
+    } while (0)
+
+// Lotes: un lote que da la vuelta al final del array y uno que solo cabe en parte.
+static void check_batches(void) {
+    AtomicEventRingBuffer *rb = ring_buffer_create(8);
+    Event in[8], out[8];
+    for (uint32_t i = 0; i < 8; i++) {
+        in[i] = (Event){ .pid = 2, .vpn = i };
+    }
+    CHECK(dequeue_events(rb, out, 8) == 0);
+    CHECK(enqueue_events(rb, in, 5) == 5);
+    CHECK(dequeue_events(rb, out, 8) == 5);
+    // Posiciones 5..10: ranuras 5, 6, 7 y después 0, 1, 2.
+    CHECK(enqueue_events(rb, in, 6) == 6);
+    CHECK(dequeue_events(rb, out, 8) == 6);
+    int ordered = 1;
+    for (uint32_t i = 0; i < 6; i++) {
+        ordered &= out[i].vpn == i;
+    }
+    CHECK(ordered);
+
+    // Un lote de 4 con 2 libres entra a medias; tras sacar 2, uno de 5 mete 2 y el siguiente 0.
+    CHECK(enqueue_events(rb, in, 6) == 6);
+    CHECK(enqueue_events(rb, &in[6], 4) == 2 && ring_buffer_size(rb) == 8);
+    CHECK(dequeue_events(rb, out, 2) == 2);
+    CHECK(enqueue_events(rb, in, 5) == 2);
+    CHECK(enqueue_events(rb, in, 5) == 0);
+    CHECK(dequeue_events(rb, out, 8) == 8);
+    static const uint32_t expect[8] = { 2, 3, 4, 5, 6, 7, 0, 1 };
+    ordered = 1;
+    for (uint32_t i = 0; i < 8; i++) {
+        ordered &= out[i].vpn == expect[i];
+    }
+    CHECK(ordered);
+    CHECK(ring_buffer_size(rb) == 0);
+    ring_buffer_destroy(rb);
+}
+
+// Sin copia: una ranura reclamada y sin publicar detiene al consumidor en su posición,
+// las publicaciones fuera de orden salen en orden de posición, y peek/release devuelve
+// la ranura. En modo sobrescritura no hay API sin copia.
+static void check_zero_copy(void) {
+    AtomicEventRingBuffer *rb = ring_buffer_create(4);
+    Event e;
+    Event *a = ring_claim(rb);
+    Event *b = ring_claim(rb);
+    CHECK(a != NULL && b != NULL && a != b);
+    *b = (Event){ .pid = 5, .vpn = 2 };
+    ring_commit(rb, b);
+    CHECK(ring_peek(rb) == NULL && dequeue_event(rb, &e) == -1); // 'a' aún sin publicar
+    *a = (Event){ .pid = 5, .vpn = 1 };
+    ring_commit(rb, a);
+    Event *p = ring_peek(rb);
+    CHECK(p != NULL && p->vpn == 1);
+    CHECK(dequeue_event(rb, &e) == 0 && e.vpn == 2); // Otro consumidor sigue con la siguiente
+    for (uint32_t i = 0; i < 2; i++) {
+        Event *c = ring_claim(rb);
+        CHECK(c != NULL);
+        if (c != NULL) {
+            *c = (Event){ .pid = 5, .vpn = 10 + i };
+            ring_commit(rb, c);
+        }
+    }
+    // Posiciones 2 y 3 llenas; la 4 es la ranura de 'p', aún del consumidor: lleno.
+    CHECK(ring_claim(rb) == NULL);
+    p->vpn = 99; // Se puede modificar en el sitio hasta ring_release
+    ring_release(rb, p);
+    Event *c = ring_claim(rb);
+    CHECK(c != NULL && c == p);
+    if (c != NULL) {
+        c->vpn = 12;
+        ring_commit(rb, c);
+    }
+    for (uint32_t i = 0; i < 3; i++) {
+        CHECK(dequeue_event(rb, &e) == 0 && e.vpn == 10 + i);
+    }
+    CHECK(ring_peek(rb) == NULL);
+    ring_buffer_destroy(rb);
+
+    rb = ring_buffer_create_ex(4, RING_FLAG_OVERWRITE);
+    e = (Event){ .pid = 5, .vpn = 1 };
+    CHECK(enqueue_event(rb, &e) == 0);
+    CHECK(ring_claim(rb) == NULL && ring_peek(rb) == NULL);
+    CHECK(dequeue_event(rb, &e) == 0 && e.vpn == 1);
+    ring_buffer_destroy(rb);
+}
+
+// Variantes SPSC/MPSC/SPMC: FIFO, lleno/vacío y vuelta completa (también por lotes), y
+// después el lado contendido de MPSC y SPMC con varios hilos.
+#define CHECK_VARIANT_FIFO(prefix)                                                        \
+    do {                                                                                  \
+        __typeof__(prefix##_ring_buffer_create(4)) rb = prefix##_ring_buffer_create(4);   \
+        Event e, in[6], out[6];                                                           \
+        CHECK(rb != NULL && prefix##_dequeue_event(rb, &e) == -1);                        \
+        for (uint32_t i = 0; i < 6; i++) {                                                \
+            in[i] = (Event){ .pid = 6, .vpn = i };                                        \
+        }                                                                                 \
+        for (uint32_t lap = 0; lap < 3; lap++) { /* 12 eventos: tres vueltas */           \
+            for (uint32_t i = 0; i < 4; i++) {                                            \
+                CHECK(prefix##_enqueue_event(rb, &in[i]) == 0);                           \
+            }                                                                             \
+            CHECK(prefix##_enqueue_event(rb, &in[4]) == -1);                              \
+            for (uint32_t i = 0; i < 4; i++) {                                            \
+                CHECK(prefix##_dequeue_event(rb, &e) == 0 && e.vpn == i);                 \
+            }                                                                             \
+            CHECK(prefix##_dequeue_event(rb, &e) == -1);                                  \
+        }                                                                                 \
+        /* Lotes: parcial con el ring casi lleno y uno que da la vuelta. */               \
+        CHECK(prefix##_enqueue_events(rb, in, 3) == 3);                                   \
+        CHECK(prefix##_enqueue_events(rb, &in[3], 3) == 1);                               \
+        CHECK(prefix##_dequeue_events(rb, out, 6) == 4);                                  \
+        CHECK(prefix##_enqueue_events(rb, in, 6) == 4);                                   \
+        CHECK(prefix##_dequeue_events(rb, out, 2) == 2 && out[0].vpn == 0 && out[1].vpn == 1); \
+        CHECK(prefix##_dequeue_events(rb, out, 6) == 2 && out[0].vpn == 2 && out[1].vpn == 3); \
+        CHECK(prefix##_dequeue_events(rb, out, 6) == 0);                                  \
+        prefix##_ring_buffer_destroy(rb);                                                 \
+    } while (0)
+
+#define VARIANT_THREADS 3
+#define VARIANT_EVENTS 20000
+
+static MpscEventRingBuffer *variant_mpsc;
+static SpmcEventRingBuffer *variant_spmc;
+static uint8_t variant_seen[VARIANT_EVENTS];
+static int variant_order_ok[VARIANT_THREADS];
+
+static void *variant_mpsc_producer(void *arg) {
+    uint32_t id = (uint32_t)(long)arg;
+    for (uint32_t i = 0; i < VARIANT_EVENTS; i++) {
+        Event e = { .pid = id, .vpn = i };
+        while (mpsc_enqueue_event(variant_mpsc, &e) != 0) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+// Cada consumidor SPMC marca lo que ve y comprueba que sus eventos crecen.
+static void *variant_spmc_consumer(void *arg) {
+    long id = (long)arg;
+    long next = 0;
+    Event e;
+    variant_order_ok[id] = 1;
+    for (;;) {
+        if (spmc_dequeue_event(variant_spmc, &e) != 0) {
+            sched_yield();
+            continue;
+        }
+        if (e.pid == 0) {
+            break; // Fin
+        }
+        if ((long)e.vpn < next || e.vpn >= VARIANT_EVENTS) {
+            variant_order_ok[id] = 0;
+        } else {
+            next = (long)e.vpn + 1;
+            variant_seen[e.vpn]++; // Cada vpn lo extrae un solo consumidor
+        }
+    }
+    return NULL;
+}
+
+static void check_variants(void) {
+    CHECK_VARIANT_FIFO(spsc);
+    CHECK_VARIANT_FIFO(mpsc);
+    CHECK_VARIANT_FIFO(spmc);
+
+    pthread_t threads[VARIANT_THREADS];
+    variant_mpsc = mpsc_ring_buffer_create(64);
+    for (long i = 0; i < VARIANT_THREADS; i++) {
+        pthread_create(&threads[i], NULL, variant_mpsc_producer, (void *)i);
+    }
+    uint32_t next[VARIANT_THREADS] = { 0 };
+    int ordered = 1;
+    for (long n = 0; n < (long)VARIANT_THREADS * VARIANT_EVENTS;) {
+        Event e;
+        if (mpsc_dequeue_event(variant_mpsc, &e) != 0) {
+            sched_yield();
+            continue;
+        }
+        if (e.pid >= VARIANT_THREADS || e.vpn != next[e.pid]) {
+            ordered = 0;
+        } else {
+            next[e.pid]++;
+        }
+        n++;
+    }
+    for (int i = 0; i < VARIANT_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    CHECK(ordered);
+    mpsc_ring_buffer_destroy(variant_mpsc);
+
+    variant_spmc = spmc_ring_buffer_create(64);
+    memset(variant_seen, 0, sizeof(variant_seen));
+    for (long i = 0; i < VARIANT_THREADS; i++) {
+        pthread_create(&threads[i], NULL, variant_spmc_consumer, (void *)i);
+    }
+    for (uint32_t i = 0; i < VARIANT_EVENTS + VARIANT_THREADS; i++) {
+        // pid 0 tras los eventos: uno por consumidor para que terminen.
+        Event e = { .pid = i < VARIANT_EVENTS ? 1 : 0, .vpn = i };
+        while (spmc_enqueue_event(variant_spmc, &e) != 0) {
+            sched_yield();
+        }
+    }
+    for (int i = 0; i < VARIANT_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+        CHECK(variant_order_ok[i]);
+    }
+    int once = 1;
+    for (uint32_t i = 0; i < VARIANT_EVENTS; i++) {
+        once &= variant_seen[i] == 1;
+    }
+    CHECK(once);
+    spmc_ring_buffer_destroy(variant_spmc);
+}
+
+// Política de espera: con spin_min 0 el presupuesto no baja de 1 (si llegara a 0 el spin
+// quedaría desactivado para siempre); con spin_max 0 no hay spin.
+static void check_wait_policy(void) {
+    AtomicEventRingBuffer *rb = ring_buffer_create(4);
+    RingWaitPolicy policy = { .spin_min = 0, .spin_max = 64, .spin_initial = 0, .park = 1 };
+    ring_buffer_set_wait_policy(rb, &policy);
+    CHECK(rb->wait_policy.spin_min == 1 && atomic_load(&rb->consumer_wait.spin) == 1);
+    Event e;
+    for (int i = 0; i < 8; i++) {
+        CHECK(dequeue_event_wait(rb, &e, 1000) == -1); // Vacío: cada espera fallida reduce
+    }
+    CHECK(atomic_load(&rb->consumer_wait.spin) == 1);
+    e = (Event){ .pid = 8, .vpn = 1 };
+    CHECK(enqueue_event_wait(rb, &e, 0) == 0 && dequeue_event_wait(rb, &e, 0) == 0 && e.vpn == 1);
+
+    policy = (RingWaitPolicy){ .spin_min = 0, .spin_max = 0, .spin_initial = 16, .park = 1 };
+    ring_buffer_set_wait_policy(rb, &policy);
+    CHECK(atomic_load(&rb->producer_wait.spin) == 0);
+    ring_buffer_destroy(rb);
+}
+
+// Ring compartido entre procesos: un hijo lo mapea con ring_buffer_attach y los eventos
+// pasan con las esperas bloqueantes de ambos lados (futex compartido). Un segundo
+// create del mismo nombre da EEXIST; un segmento con otro layout o capacidad, EINVAL.
+#define SHARED_EVENTS 2000
+#define SHARED_WAIT_NS 2000000000LL
+
+static void check_shared_ring(void) {
+    char name[64];
+    snprintf(name, sizeof(name), "/aerb-check-%d", (int)getpid());
+    AtomicEventRingBuffer *rb = ring_buffer_create_shared(name, 8);
+    CHECK(rb != NULL);
+    if (rb == NULL) {
+        return;
+    }
+    errno = 0;
+    CHECK(ring_buffer_create_shared(name, 8) == NULL && errno == EEXIST);
+
+    pid_t child = fork();
+    if (child == 0) {
+        // Hijo: consume los eventos en orden, durmiendo con el ring vacío.
+        AtomicEventRingBuffer *peer = ring_buffer_attach(name);
+        if (peer == NULL) {
+            _exit(2);
+        }
+        for (uint32_t i = 0; i < SHARED_EVENTS; i++) {
+            Event e;
+            if (dequeue_event_wait(peer, &e, SHARED_WAIT_NS) != 0 || e.pid != 1 || e.vpn != i) {
+                _exit(3);
+            }
+        }
+        ring_buffer_destroy(peer); // Solo desmapea
+        _exit(0);
+    }
+    CHECK(child > 0);
+
+    // Padre: 2000 eventos por un ring de 8 ranuras; con el ring lleno duerme hasta que
+    // el hijo lo despierta desde el otro proceso.
+    int timeouts = 0;
+    for (uint32_t i = 0; child > 0 && i < SHARED_EVENTS; i++) {
+        Event e = { .pid = 1, .vpn = i };
+        if (enqueue_event_wait(rb, &e, SHARED_WAIT_NS) != 0) {
+            timeouts++;
+            break;
+        }
+    }
+    int status = -1;
+    if (child > 0) {
+        waitpid(child, &status, 0);
+    }
+    CHECK(timeouts == 0);
+    CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    CHECK(ring_buffer_size(rb) == 0);
+
+    // Capacidad corrupta en la cabecera y segmento de otro tamaño: EINVAL.
+    uint64_t capacity = rb->capacity;
+    rb->capacity = 6;
+    errno = 0;
+    CHECK(ring_buffer_attach(name) == NULL && errno == EINVAL);
+    rb->capacity = capacity;
+    AtomicEventRingBuffer *again = ring_buffer_attach(name);
+    CHECK(again != NULL);
+    if (again != NULL) {
+        ring_buffer_destroy(again);
+    }
+    int fd = shm_open(name, O_RDWR, 0);
+    CHECK(fd >= 0 && ftruncate(fd, 1 << 20) == 0);
+    if (fd >= 0) {
+        close(fd);
+    }
+    errno = 0;
+    CHECK(ring_buffer_attach(name) == NULL && errno == EINVAL);
+
+    ring_buffer_destroy(rb);
+    CHECK(ring_buffer_unlink_shared(name) == 0);
+    errno = 0;
+    CHECK(ring_buffer_attach(name) == NULL && errno == ENOENT);
+}
+
+// Eventfd: armado con el ring vacío, el siguiente enqueue lo hace legible en epoll; tras
+// el ack deja de serlo, y armar con eventos pendientes retorna 1 sin armar.
+static void check_eventfd(void) {
+    AtomicEventRingBuffer *rb = ring_buffer_create(8);
+    int fd = ring_buffer_enable_eventfd(rb);
+    CHECK(fd >= 0 && ring_buffer_enable_eventfd(rb) == fd);
+    int ep = epoll_create1(EPOLL_CLOEXEC);
+    struct epoll_event ev = { .events = EPOLLIN, .data.fd = fd };
+    CHECK(ep >= 0 && epoll_ctl(ep, EPOLL_CTL_ADD, fd, &ev) == 0);
+    struct epoll_event got;
+    Event e = { .pid = 10, .vpn = 1 };
+
+    CHECK(enqueue_event(rb, &e) == 0);
+    CHECK(epoll_wait(ep, &got, 1, 0) == 0); // Sin armar no se señaliza
+    CHECK(ring_eventfd_arm(rb) == 1);       // Pendiente: sigue vaciando
+    CHECK(dequeue_event(rb, &e) == 0);
+    for (int round = 0; round < 2; round++) {
+        CHECK(ring_eventfd_arm(rb) == 0); // Vacío: armado
+        CHECK(epoll_wait(ep, &got, 1, 0) == 0);
+        e.vpn = 2 + (uint32_t)round;
+        CHECK(enqueue_event(rb, &e) == 0);
+        CHECK(epoll_wait(ep, &got, 1, 100) == 1 && got.data.fd == fd);
+        ring_eventfd_ack(rb);
+        CHECK(epoll_wait(ep, &got, 1, 0) == 0);
+        CHECK(dequeue_event(rb, &e) == 0 && e.vpn == 2 + (uint32_t)round);
+        // Ya desarmado por el productor: otro enqueue no vuelve a señalizar.
+        CHECK(enqueue_event(rb, &e) == 0 && epoll_wait(ep, &got, 1, 0) == 0);
+        CHECK(dequeue_event(rb, &e) == 0);
+    }
+    close(ep);
+    ring_buffer_destroy(rb);
+
+    AtomicEventRingBuffer *shared = NULL;
+    char name[64];
+    snprintf(name, sizeof(name), "/aerb-efd-%d", (int)getpid());
+    shared = ring_buffer_create_shared(name, 8);
+    CHECK(shared != NULL);
+    if (shared != NULL) {
+        errno = 0;
+        CHECK(ring_buffer_enable_eventfd(shared) == -1 && errno == EINVAL);
+        ring_buffer_destroy(shared);
+        ring_buffer_unlink_shared(name);
+    }
+}
+
+// Latencia: límites de bucket y percentiles sobre un histograma conocido, la suma del
+// snapshot con varios hilos consumidores, y hilos efímeros que pasan de las 16 entradas.
+#define LATENCY_THREADS 4
+#define LATENCY_EVENTS 100
+#define LATENCY_CHURN (3 * RING_LATENCY_MAX_CONSUMERS)
+
+static AtomicEventRingBuffer *latency_ring_under_test;
+
+static void *latency_consumer(void *arg) {
+    long want = (long)arg;
+    Event e;
+    for (long got = 0; got < want;) {
+        if (dequeue_event(latency_ring_under_test, &e) == 0) {
+            got++;
+        } else {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void check_latency(void) {
+    // Por debajo de 64 ns un bucket por ns; después 32 buckets por potencia de dos.
+    CHECK(ring_latency_bucket_floor(0) == 0 && ring_latency_bucket_floor(63) == 63);
+    CHECK(ring_latency_bucket_floor(64) == 64 && ring_latency_bucket_floor(65) == 66);
+    CHECK(ring_latency_bucket_floor(95) == 126 && ring_latency_bucket_floor(96) == 128);
+    CHECK(ring_latency_bucket_floor(97) == 132);
+    int contiguous = 1;
+    for (size_t b = 2 * RING_LATENCY_SUB_BUCKETS; b + 1 < RING_LATENCY_BUCKETS; b++) {
+        uint64_t width = ring_latency_bucket_floor(b + 1) - ring_latency_bucket_floor(b);
+        contiguous &= width == 1ULL << (b / RING_LATENCY_SUB_BUCKETS - 1);
+    }
+    CHECK(contiguous);
+
+    static RingLatencyHistogram h;
+    memset(&h, 0, sizeof(h));
+    atomic_store(&h.buckets[10], 50);
+    atomic_store(&h.buckets[97], 49);
+    atomic_store(&h.buckets[200], 1);
+    atomic_store(&h.count, 100);
+    atomic_store(&h.max_ns, 5000);
+    CHECK(ring_latency_percentile(&h, 0.5) == 10);
+    CHECK(ring_latency_percentile(&h, 0.9) == 135); // Límite superior del bucket [132, 136)
+    CHECK(ring_latency_percentile(&h, 1.0) == 1311); // Bucket [1280, 1312)
+    atomic_store(&h.max_ns, 1300);
+    CHECK(ring_latency_percentile(&h, 1.0) == 1300); // Acotado por max_ns
+    atomic_store(&h.count, 0);
+    CHECK(ring_latency_percentile(&h, 0.5) == 0);
+
+    RingLatencyHistogram snap;
+    AtomicEventRingBuffer *rb = ring_buffer_create_ex(512, RING_FLAG_LATENCY);
+    CHECK(ring_latency_snapshot(rb, &snap) == 0 && atomic_load(&snap.count) == 0);
+    latency_ring_under_test = rb;
+    Event e = { .pid = 12, .vpn = 0 };
+    for (int i = 0; i < LATENCY_THREADS * LATENCY_EVENTS; i++) {
+        CHECK(enqueue_event(rb, &e) == 0);
+    }
+    pthread_t threads[LATENCY_THREADS];
+    for (int i = 0; i < LATENCY_THREADS; i++) {
+        pthread_create(&threads[i], NULL, latency_consumer, (void *)(long)LATENCY_EVENTS);
+    }
+    for (int i = 0; i < LATENCY_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    CHECK(ring_latency_snapshot(rb, &snap) == 0);
+    uint64_t in_buckets = 0;
+    for (size_t b = 0; b < RING_LATENCY_BUCKETS; b++) {
+        in_buckets += atomic_load(&snap.buckets[b]);
+    }
+    CHECK(atomic_load(&snap.count) == LATENCY_THREADS * LATENCY_EVENTS && in_buckets == atomic_load(&snap.count));
+    CHECK(ring_latency_percentile(&snap, 0.99) <= atomic_load(&snap.max_ns));
+
+    // Hilos que consumen un evento y terminan: sin heredar entradas, solo se medirían 16.
+    for (int i = 0; i < LATENCY_CHURN; i++) {
+        CHECK(enqueue_event(rb, &e) == 0);
+        pthread_create(&threads[0], NULL, latency_consumer, (void *)1L);
+        pthread_join(threads[0], NULL);
+    }
+    CHECK(ring_latency_snapshot(rb, &snap) == 0);
+    CHECK(atomic_load(&snap.count) == LATENCY_THREADS * LATENCY_EVENTS + LATENCY_CHURN);
+    ring_buffer_destroy(rb);
+
+    rb = ring_buffer_create(8);
+    CHECK(ring_latency_snapshot(rb, &snap) == -1);
+    ring_buffer_destroy(rb);
+}
+
+// Sobrescritura: al dar la vuelta el consumidor salta a lo más antiguo que sigue en el
+// ring y cuenta lo saltado. Con varios hilos, el seqlock nunca entrega un par mezclado.
+#define LOSSY_THREADS 2
+#define LOSSY_EVENTS 20000
+
+static AtomicEventRingBuffer *lossy_ring_under_test;
+static atomic_int lossy_producers_done;
+static atomic_uint_least64_t lossy_delivered;
+static atomic_int lossy_torn;
+
+static void *lossy_producer(void *arg) {
+    uint32_t base = (uint32_t)(long)arg * LOSSY_EVENTS;
+    for (uint32_t i = 0; i < LOSSY_EVENTS; i++) {
+        Event e = { .pid = base + i, .vpn = base + i };
+        enqueue_event(lossy_ring_under_test, &e);
+        if (i % 64 == 0) {
+            sched_yield(); // Que los consumidores se crucen con escrituras a medias
+        }
+    }
+    return NULL;
+}
+
+static void *lossy_consumer(void *arg) {
+    (void)arg;
+    Event e;
+    uint64_t lost;
+    for (;;) {
+        int done = atomic_load(&lossy_producers_done);
+        if (dequeue_event_lossy(lossy_ring_under_test, &e, &lost) == 0) {
+            if (e.pid != e.vpn) {
+                atomic_fetch_add(&lossy_torn, 1);
+            }
+            atomic_fetch_add(&lossy_delivered, 1);
+        } else if (done) {
+            return NULL; // Vacío después de que terminaran los productores
+        } else {
+            sched_yield();
+        }
+    }
+}
+
+static void check_lossy(void) {
+    AtomicEventRingBuffer *rb = ring_buffer_create_ex(4, RING_FLAG_OVERWRITE);
+    Event e;
+    uint64_t lost = 99;
+    for (uint32_t i = 0; i < 10; i++) {
+        Event in = { .pid = 15, .vpn = i };
+        CHECK(enqueue_event(rb, &in) == 0); // Nunca lleno
+    }
+    // Quedan 6..9: el primer dequeue salta 0..5.
+    CHECK(dequeue_event_lossy(rb, &e, &lost) == 0 && e.vpn == 6 && lost == 6);
+    for (uint32_t i = 7; i < 10; i++) {
+        CHECK(dequeue_event_lossy(rb, &e, &lost) == 0 && e.vpn == i && lost == 0);
+    }
+    CHECK(dequeue_event_lossy(rb, &e, &lost) == -1);
+    CHECK(ring_buffer_lost(rb) == 6);
+
+    // Segunda vuelta a medio consumir: 'head' en 11 y 'tail' en 18 salta 11..13.
+    for (uint32_t i = 10; i < 18; i++) {
+        Event in = { .pid = 15, .vpn = i };
+        CHECK(enqueue_event(rb, &in) == 0);
+        if (i == 11) {
+            CHECK(dequeue_event_lossy(rb, &e, &lost) == 0 && e.vpn == 10 && lost == 0);
+        }
+    }
+    CHECK(dequeue_event_lossy(rb, &e, &lost) == 0 && e.vpn == 14 && lost == 3);
+    CHECK(dequeue_event(rb, &e) == 0 && e.vpn == 15); // dequeue_event también salta sin avisar
+    CHECK(ring_buffer_lost(rb) == 9);
+    ring_buffer_destroy(rb);
+
+    // Sin RING_FLAG_OVERWRITE no se pierde nada y 'lost' sale a 0.
+    rb = ring_buffer_create(4);
+    Event in = { .pid = 15, .vpn = 1 };
+    lost = 99;
+    CHECK(enqueue_event(rb, &in) == 0);
+    CHECK(dequeue_event_lossy(rb, &e, &lost) == 0 && e.vpn == 1 && lost == 0);
+    ring_buffer_destroy(rb);
+
+    // MPMC sobre un ring diminuto: todo lo publicado se entrega íntegro o se cuenta como perdido.
+    rb = ring_buffer_create_ex(4, RING_FLAG_OVERWRITE);
+    lossy_ring_under_test = rb;
+    atomic_store(&lossy_producers_done, 0);
+    atomic_store(&lossy_delivered, 0);
+    atomic_store(&lossy_torn, 0);
+    pthread_t producers[LOSSY_THREADS], consumers[LOSSY_THREADS];
+    for (long i = 0; i < LOSSY_THREADS; i++) {
+        pthread_create(&consumers[i], NULL, lossy_consumer, NULL);
+        pthread_create(&producers[i], NULL, lossy_producer, (void *)i);
+    }
+    for (int i = 0; i < LOSSY_THREADS; i++) {
+        pthread_join(producers[i], NULL);
+    }
+    atomic_store(&lossy_producers_done, 1);
+    for (int i = 0; i < LOSSY_THREADS; i++) {
+        pthread_join(consumers[i], NULL);
+    }
+    CHECK(atomic_load(&lossy_torn) == 0);
+    CHECK(atomic_load(&lossy_delivered) + ring_buffer_lost(rb) == LOSSY_THREADS * LOSSY_EVENTS);
+    ring_buffer_destroy(rb);
+}
+
+// Pipeline: la última etapa vacía un ring lleno mientras los productores duermen en
+// enqueue_event_wait. Un despertar perdido se ve como un timeout.
+#define PIPE_PRODUCERS 2
+#define PIPE_EVENTS 3000
+#define PIPE_WAIT_NS 2000000000LL
+
+typedef struct {
+    AtomicEventRingBuffer *rb;
+    RingPipeline *p;
+    atomic_int timeouts;
+    long seen;
+    int order_ok;
+} PipeCheck;
+
+static PipeCheck pipe_check;
+
+static void *pipe_producer(void *arg) {
+    uint32_t id = (uint32_t)(long)arg;
+    for (uint32_t i = 0; i < PIPE_EVENTS; i++) {
+        Event event = { .pid = id, .vpn = i };
+        while (enqueue_event_wait(pipe_check.rb, &event, PIPE_WAIT_NS) != 0) {
+            atomic_fetch_add(&pipe_check.timeouts, 1);
+        }
+    }
+    return NULL;
+}
+
+// Etapa 0 marca el evento; etapa 1 (final) comprueba la marca y el orden por productor.
+static void *pipe_stage(void *arg) {
+    uint32_t stage = (uint32_t)(long)arg;
+    uint32_t next[PIPE_PRODUCERS] = { 0 };
+    long done = 0;
+    while (done < (long)PIPE_PRODUCERS * PIPE_EVENTS) {
+        uint64_t pos;
+        size_t n = ring_stage_available(pipe_check.p, stage, &pos);
+        if (n == 0) {
+            usleep(stage == 1 ? 200 : 0); // Final lenta: los productores llenan el ring y duermen
+            continue;
+        }
+        for (size_t i = 0; i < n; i++) {
+            Event *e = ring_stage_event(pipe_check.p, pos + i);
+            if (stage == 0) {
+                e->pid |= 0x100;
+            } else {
+                uint32_t producer = e->pid & 0xff;
+                if (!(e->pid & 0x100) || producer >= PIPE_PRODUCERS || e->vpn != next[producer]) {
+                    pipe_check.order_ok = 0;
+                } else {
+                    next[producer]++;
+                }
+            }
+        }
+        ring_stage_commit(pipe_check.p, stage, n);
+        done += (long)n;
+    }
+    if (stage == 1) {
+        pipe_check.seen = done;
+    }
+    return NULL;
+}
+
+static void check_pipeline_blocking(void) {
+    pipe_check.rb = ring_buffer_create(4);
+    pipe_check.p = ring_pipeline_create(pipe_check.rb);
+    CHECK(ring_pipeline_add_stage(pipe_check.p, 0) == 0);
+    CHECK(ring_pipeline_add_stage(pipe_check.p, 1u << 0) == 1);
+    CHECK(ring_pipeline_add_stage(pipe_check.p, 1u << 5) == -1); // Etapa inexistente
+    atomic_store(&pipe_check.timeouts, 0);
+    pipe_check.order_ok = 1;
+
+    pthread_t threads[PIPE_PRODUCERS + 2];
+    for (long i = 0; i < PIPE_PRODUCERS; i++) {
+        pthread_create(&threads[i], NULL, pipe_producer, (void *)i);
+    }
+    for (long i = 0; i < 2; i++) {
+        pthread_create(&threads[PIPE_PRODUCERS + i], NULL, pipe_stage, (void *)i);
+    }
+    for (int i = 0; i < PIPE_PRODUCERS + 2; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    CHECK(atomic_load(&pipe_check.timeouts) == 0);
+    CHECK(pipe_check.order_ok);
+    CHECK(pipe_check.seen == (long)PIPE_PRODUCERS * PIPE_EVENTS);
+    CHECK(ring_buffer_size(pipe_check.rb) == 0);
+    ring_pipeline_destroy(pipe_check.p);
+    ring_buffer_destroy(pipe_check.rb);
+}
+
+// Ring de bytes: un ring lleno se recorre una sola vez (sin volver a empezar por el primer
+// registro) y un registro que no cabe al final salta al principio tras el relleno.
+static void check_byte_ring(void) {
+    ByteRingBuffer *rb = byte_ring_create(64);
+    CHECK(rb != NULL && rb->max_record == 24);
+    uint8_t a[24], b[24], c[8];
+    memset(a, 'A', sizeof(a));
+    memset(b, 'B', sizeof(b));
+    memset(c, 'C', sizeof(c));
+    uint32_t length;
+    const uint8_t *r;
+
+    // Dos registros de 24 + 8 bytes de cabecera llenan los 64 bytes.
+    CHECK(byte_ring_write(rb, a, sizeof(a)) == 0);
+    CHECK(byte_ring_write(rb, b, sizeof(b)) == 0);
+    CHECK(byte_ring_write(rb, c, sizeof(c)) == -1); // Lleno
+    r = byte_ring_next(rb, &length);
+    CHECK(r != NULL && length == 24 && r[0] == 'A');
+    r = byte_ring_next(rb, &length);
+    CHECK(r != NULL && length == 24 && r[0] == 'B');
+    CHECK(byte_ring_next(rb, &length) == NULL);
+    CHECK(byte_ring_next(rb, &length) == NULL);
+    byte_ring_release(rb);
+
+    // Tras tres registros de 8 (48 bytes) quedan 16 hasta el final: el de 24 va con relleno.
+    for (int i = 0; i < 3; i++) {
+        CHECK(byte_ring_write(rb, c, sizeof(c)) == 0);
+        r = byte_ring_next(rb, &length);
+        CHECK(r != NULL && length == 8 && r[0] == 'C');
+        byte_ring_release(rb);
+    }
+    CHECK(byte_ring_write(rb, a, sizeof(a)) == 0);
+    CHECK(byte_ring_write(rb, c, sizeof(c)) == 0);
+    r = byte_ring_next(rb, &length);
+    CHECK(r != NULL && length == 24 && r[0] == 'A' && r == &rb->data[sizeof(ByteRecordHeader)]);
+    r = byte_ring_next(rb, &length);
+    CHECK(r != NULL && length == 8 && r[0] == 'C');
+    CHECK(byte_ring_next(rb, &length) == NULL);
+    byte_ring_release(rb);
+    CHECK(atomic_load(&rb->head) == atomic_load(&rb->tail));
+    byte_ring_destroy(rb);
+}
+
+// RingSet: el robo por ocupación elige el shard más lleno y no gira sin fin sobre un
+// shard con posiciones reclamadas y aún sin publicar.
+static void check_ring_set_steal(void) {
+    Event events[8];
+    Event e = { .pid = 0, .vpn = 0 };
+
+    RingSet *set = ring_set_create(3, 8, RING_SET_STEAL_OCCUPANCY);
+    CHECK(set != NULL);
+    e.pid = 1;
+    CHECK(ring_set_enqueue_events(set, 1, (Event[]){ e, e, e }, 3) == 3);
+    e.pid = 2;
+    CHECK(ring_set_enqueue(set, 2, &e) == 0);
+    CHECK(ring_set_dequeue_events(set, 0, events, 8) == 3 && events[0].pid == 1);
+    CHECK(ring_set_dequeue_events(set, 0, events, 8) == 1 && events[0].pid == 2);
+
+    // Ocupación 1 en el shard 1, pero sin publicar: vacío en vez de esperar al productor.
+    Event *claimed = ring_claim(set->shards[1]);
+    CHECK(claimed != NULL);
+    CHECK(ring_set_dequeue(set, 0, &e) == -1);
+    claimed->pid = 7;
+    ring_commit(set->shards[1], claimed);
+    CHECK(ring_set_dequeue(set, 0, &e) == 0 && e.pid == 7);
+    CHECK(ring_set_size(set) == 0);
+    ring_set_destroy(set);
+
+    // Round-robin: el shard de casa primero, después los demás.
+    set = ring_set_create(3, 8, RING_SET_STEAL_ROUND_ROBIN);
+    CHECK(set != NULL);
+    e.pid = 3;
+    CHECK(ring_set_enqueue(set, 2, &e) == 0);
+    e.pid = 4;
+    CHECK(ring_set_enqueue(set, 0, &e) == 0);
+    CHECK(ring_set_dequeue(set, 0, &e) == 0 && e.pid == 4);
+    CHECK(ring_set_dequeue(set, 0, &e) == 0 && e.pid == 3);
+    CHECK(ring_set_dequeue(set, 0, &e) == -1);
+    ring_set_destroy(set);
+}
+
+// Reserva con mmap: sin huge pages ni NUMA en la máquina el ring se crea igual y no
+// deja un errno de los intentos fallidos; un nodo explícito inválido sí es un error.
+static void check_alloc_policy(void) {
+    errno = 0;
+    AtomicEventRingBuffer *rb = ring_buffer_create_alloc(1024, 0, NULL);
+    CHECK(rb != NULL && errno == 0);
+    if (rb != NULL) {
+        Event e = { .pid = 1, .vpn = 2 };
+        CHECK(enqueue_event(rb, &e) == 0 && dequeue_event(rb, &e) == 0 && e.vpn == 2);
+        // La longitud del mapeo queda en la cabecera, para que destroy no la recalcule.
+        CHECK((rb->flags & RING_FLAG_MAPPED) && rb->map_bytes >= sizeof(*rb) + 1024 * sizeof(EventSlot));
+        CHECK(rb->map_bytes % (size_t)sysconf(_SC_PAGESIZE) == 0);
+        ring_buffer_destroy(rb);
+    }
+    RingAllocPolicy policy = { .huge_pages = 0, .populate = 0, .numa_node = 4096 };
+    errno = 0;
+    CHECK(ring_buffer_create_alloc(1024, 0, &policy) == NULL && errno == EINVAL);
+}
+
+// Coalescedor: con más eventos que 'batch' la tabla crece y cada fallo sale una vez.
+static void check_fault_coalescer(void) {
+    FaultCoalescer *c = fault_coalescer_create(4);
+    CHECK(c != NULL);
+    static const uint32_t vpns[10] = { 1, 1, 2, 2, 2, 3, 3, 3, 3, 3 };
+    Event events[10];
+    CoalescedFault out[10];
+    for (int i = 0; i < 10; i++) {
+        events[i] = (Event){ .pid = 9, .vpn = vpns[i] };
+    }
+    // Más que 'batch': la tabla crece y cada página sale una vez.
+    CHECK(fault_coalesce(c, events, 10, out) == 3);
+    CHECK(out[0].event.vpn == 1 && out[0].count == 2);
+    CHECK(out[1].event.vpn == 2 && out[1].count == 3);
+    CHECK(out[2].event.vpn == 3 && out[2].count == 5);
+    CHECK(c->events_in == 10 && c->faults_out == 3);
+    // Después sigue sirviendo para lotes normales, sin restos del anterior.
+    CHECK(fault_coalesce(c, events + 8, 2, out) == 1 && out[0].event.vpn == 3 && out[0].count == 2);
+    fault_coalescer_destroy(c);
+}
+
+// Difusión: todos los suscriptores ven cada evento en orden; con el ring lleno, o falla
+// el enqueue o se desengancha al más lento, según 'detach_laggards'.
+static void check_broadcast_laggard(void) {
+    for (uint32_t detach = 0; detach < 2; detach++) {
+        BroadcastRingBuffer *rb = broadcast_ring_create(4, detach);
+        CHECK(rb != NULL);
+        int fast = broadcast_ring_subscribe(rb);
+        int slow = broadcast_ring_subscribe(rb);
+        CHECK(fast >= 0 && slow >= 0 && fast != slow);
+        Event e;
+        for (uint32_t i = 0; i < 4; i++) {
+            e = (Event){ .pid = 1, .vpn = i };
+            CHECK(broadcast_enqueue_event(rb, &e) == 0);
+            CHECK(broadcast_dequeue_event(rb, fast, &e) == 0 && e.vpn == i);
+        }
+        CHECK(broadcast_ring_lag(rb, slow) == 4);
+        e = (Event){ .pid = 1, .vpn = 4 };
+        if (!detach) {
+            CHECK(broadcast_enqueue_event(rb, &e) == -1); // El lento frena al productor
+            CHECK(broadcast_dequeue_event(rb, slow, &e) == 0 && e.vpn == 0);
+            CHECK(broadcast_ring_lag(rb, slow) == 3);
+        } else {
+            CHECK(broadcast_enqueue_event(rb, &e) == 0); // Desengancha al lento
+            CHECK(broadcast_dequeue_event(rb, fast, &e) == 0 && e.vpn == 4);
+            CHECK(broadcast_dequeue_event(rb, slow, &e) == BROADCAST_DETACHED);
+            broadcast_ring_unsubscribe(rb, slow);
+            CHECK(broadcast_ring_subscribe(rb) >= 0); // La entrada vuelve a estar libre
+        }
+        CHECK(broadcast_dequeue_event(rb, fast, &e) == -1);
+        broadcast_ring_destroy(rb);
+    }
+}
+
+// Carriles de prioridad: el estricto vacía siempre primero el carril 0; el ponderado
+// {4, 1} sigue los turnos 0 0 1 0 0 mientras ambos tengan eventos.
+static void check_priority_order(void) {
+    Event e;
+    uint32_t lane;
+    PriorityRing *pr = priority_ring_create(2, 8, NULL);
+    CHECK(pr != NULL);
+    for (uint32_t i = 0; i < 3; i++) {
+        e = (Event){ .pid = 1, .vpn = i };
+        CHECK(priority_ring_enqueue(pr, 1, &e) == 0);
+    }
+    for (uint32_t i = 0; i < 2; i++) {
+        e = (Event){ .pid = 0, .vpn = i };
+        CHECK(priority_ring_enqueue(pr, 0, &e) == 0);
+    }
+    static const uint32_t strict[5][2] = { { 0, 0 }, { 0, 1 }, { 1, 0 }, { 1, 1 }, { 1, 2 } };
+    for (int i = 0; i < 5; i++) {
+        CHECK(priority_ring_dequeue_events(pr, &e, 1, &lane) == 1 && lane == strict[i][0] &&
+              e.pid == strict[i][0] && e.vpn == strict[i][1]);
+    }
+    CHECK(priority_ring_dequeue(pr, &e) == -1);
+    // Carril fuera de rango: no se encola en ninguno.
+    CHECK(priority_ring_enqueue(pr, 2, &e) == -1 && priority_ring_enqueue_events(pr, 7, &e, 1) == 0);
+    CHECK(priority_ring_lane_size(pr, 2) == 0 && priority_ring_size(pr) == 0);
+    priority_ring_destroy(pr);
+
+    pr = priority_ring_create(2, 16, (const uint32_t[]){ 4, 1 });
+    CHECK(pr != NULL);
+    for (uint32_t i = 0; i < 10; i++) {
+        e = (Event){ .pid = 0, .vpn = i };
+        CHECK(priority_ring_enqueue(pr, 0, &e) == 0);
+        e.pid = 1;
+        CHECK(priority_ring_enqueue(pr, 1, &e) == 0);
+    }
+    static const uint32_t weighted[10] = { 0, 0, 1, 0, 0, 0, 0, 1, 0, 0 };
+    for (int i = 0; i < 10; i++) {
+        CHECK(priority_ring_dequeue_events(pr, &e, 1, &lane) == 1 && lane == weighted[i]);
+    }
+    CHECK(priority_ring_lane_size(pr, 0) == 2 && priority_ring_lane_size(pr, 1) == 8);
+    // Carril 0 vacío: sus turnos pasan al carril 1.
+    for (int i = 0; i < 2; i++) {
+        CHECK(priority_ring_dequeue(pr, &e) == 0);
+    }
+    for (int i = 0; i < 8; i++) {
+        CHECK(priority_ring_dequeue_events(pr, &e, 1, &lane) == 1 && lane == 1);
+    }
+    CHECK(priority_ring_size(pr) == 0);
+    priority_ring_destroy(pr);
+}
+
+static void run_checks(void) {
+    check_batches();
+    check_zero_copy();
+    check_variants();
+    check_wait_policy();
+    check_shared_ring();
+    check_eventfd();
+    check_latency();
+    check_lossy();
+    check_fault_coalescer();
+    check_alloc_policy();
+    check_byte_ring();
+    check_broadcast_laggard();
+    check_ring_set_steal();
+    check_priority_order();
+    check_pipeline_blocking();
+    printf("Checks: %s\n", checks_failed == 0 ? "OK" : "FAILED");
+}
 
 // --- PRODUCTOR ---
 void* producer_thread(void* arg) {
@@ -27,18 +919,18 @@ void* producer_thread(void* arg) {
 
     for (long i = 0; i < EVENTS_PER_PRODUCER; i++) {
         Event event = {
-            .event_id = ((uint64_t)thread_id << 32) | i,
             .pid = (uint32_t)(thread_id + 1000),
             .vpn = (uint32_t)(i % 1024)
         };
-        if (enqueue_event(&global_ring_buffer, &event) == 0) {
+        // Backpressure: con el ring lleno el productor espera (spin y futex)
+        // en lugar de descartar el evento.
+        if (enqueue_event_wait(global_ring_buffer, &event, -1) == 0) {
             success_count++;
             atomic_fetch_add(&total_produced, 1);
-        } else {
-            usleep(1); // Backpressure
         }
     }
 
+    atomic_fetch_add(&producers_finished, 1);
     syslog(LOG_INFO, "Producer %ld finished: %d events", thread_id, success_count);
     return (void*)(long)success_count;
 }
@@ -50,19 +942,23 @@ void* consumer_thread(void* arg) {
     Event event;
     syslog(LOG_INFO, "Consumer %ld started", thread_id);
 
-    while (success_count < (EVENTS_PER_PRODUCER * NUM_PRODUCERS) / NUM_CONSUMERS) {
-        if (dequeue_event(&global_ring_buffer, &event) == 0) {
+    for (;;) {
+        // Se lee antes de intentar el dequeue: si ya terminaron todos y el buffer
+        // está vacío, no quedan eventos por llegar.
+        int producers_done = atomic_load(&producers_finished) == NUM_PRODUCERS;
+
+        // Espera bloqueante: spin acotado y después futex, en lugar de sondear con usleep.
+        if (dequeue_event_wait(global_ring_buffer, &event, CONSUMER_WAIT_NS) == 0) {
             // Verificar integridad
-            uint32_t expected_pid = (event.event_id >> 32) + 1000;
-            if (event.pid != expected_pid) {
-                syslog(LOG_ERR, "Consumer %ld: Corrupted event %lu (PID %u, expected %u)",
-                       thread_id, event.event_id, event.pid, expected_pid);
+            if (event.pid < 1000 || event.pid >= 1000 + NUM_PRODUCERS || event.vpn >= 1024) {
+                syslog(LOG_ERR, "Consumer %ld: Corrupted event (PID %u, VPN %u)",
+                       thread_id, event.pid, event.vpn);
             }
             success_count++;
             atomic_fetch_add(&total_consumed, 1);
             usleep(CONSUMER_DELAY_US); // Simular VMM lento
-        } else {
-            usleep(1);
+        } else if (producers_done) {
+            break;
         }
     }
 
@@ -73,9 +969,14 @@ void* consumer_thread(void* arg) {
 // --- MAIN ---
 int main(void) {
     openlog("RingBufferStress", LOG_PID|LOG_CONS, LOG_USER);
+    run_checks();
     printf("--- Stress Testing Ring Buffer ---\n");
 
-    ring_buffer_init(&global_ring_buffer);
+    global_ring_buffer = ring_buffer_create(RING_CAPACITY);
+    if (global_ring_buffer == NULL) {
+        fprintf(stderr, "No se pudo crear el ring buffer\n");
+        return 1;
+    }
 
     pthread_t producers[NUM_PRODUCERS], consumers[NUM_CONSUMERS];
     long total_success_produced = 0, total_success_consumed = 0;
@@ -105,19 +1006,26 @@ int main(void) {
     }
 
     // Verificar estado final
-    uint64_t head = atomic_load_explicit(&global_ring_buffer.head, memory_order_relaxed);
-    uint64_t tail = atomic_load_explicit(&global_ring_buffer.tail, memory_order_relaxed);
+    uint64_t head = atomic_load_explicit(&global_ring_buffer->head, memory_order_relaxed);
+    uint64_t tail = atomic_load_explicit(&global_ring_buffer->tail, memory_order_relaxed);
 
     printf("\n--- Test Summary ---\n");
-    printf("Produced: %d, Consumed: %d\n", total_success_produced, total_success_consumed);
-    printf("Final state: Head=%lu, Tail=%lu\n", head, tail);
+    printf("Produced: %ld, Consumed: %ld\n", total_success_produced, total_success_consumed);
+    printf("Final state: Head=%" PRIu64 ", Tail=%" PRIu64 "\n", head, tail);
 
-    if (total_success_produced == total_success_consumed && head == tail) {
+    // head y tail son contadores libres: tras vaciar el ring ambos valen el
+    // número total de eventos que pasaron por él.
+    int ok = checks_failed == 0 &&
+             total_success_produced == (long)NUM_PRODUCERS * EVENTS_PER_PRODUCER &&
+             total_success_produced == total_success_consumed && head == tail &&
+             tail == (uint64_t)total_success_produced;
+    if (ok) {
         printf("SUCCESS: All events processed correctly\n");
     } else {
         printf("FAILURE: Inconsistent state\n");
     }
 
+    ring_buffer_destroy(global_ring_buffer);
     closelog();
-    return 0;
+    return ok ? 0 : 1;
 }
@@ -0,0 +1,154 @@
+#define _GNU_SOURCE // syscall() del futex en ring_internal.h
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "priority_ring.h"
+#include "ring_internal.h"
+
+// --- CREACIÓN / DESTRUCCIÓN ---
+// Round-robin ponderado suave (el de nginx): en cada turno todos los carriles suman su
+// peso a su crédito, gana el de más crédito y se le resta W. Con pesos {4, 1} da
+// 0 0 1 0 0 en vez de 0 0 0 0 1.
+static void build_schedule(PriorityRing *pr, const uint32_t *weights) {
+    int64_t credit[PRIORITY_RING_MAX_LANES] = { 0 };
+    for (uint32_t t = 0; t < pr->schedule_len; t++) {
+        uint32_t best = 0;
+        for (uint32_t i = 0; i < pr->lane_count; i++) {
+            credit[i] += weights[i];
+            if (credit[i] > credit[best]) {
+                best = i;
+            }
+        }
+        credit[best] -= pr->schedule_len;
+        pr->schedule[t] = (uint8_t)best;
+    }
+}
+
+PriorityRing *priority_ring_create(uint32_t lanes, uint64_t capacity, const uint32_t *weights) {
+    if (lanes == 0 || lanes > PRIORITY_RING_MAX_LANES) {
+        return NULL;
+    }
+    uint32_t total = 0;
+    if (weights != NULL) {
+        for (uint32_t i = 0; i < lanes; i++) {
+            if (weights[i] == 0 || weights[i] > PRIORITY_RING_MAX_SCHEDULE) {
+                return NULL;
+            }
+            total += weights[i];
+        }
+        if (total > PRIORITY_RING_MAX_SCHEDULE) {
+            return NULL;
+        }
+    }
+
+    PriorityRing *pr = ring_alloc(sizeof(PriorityRing) + total);
+    if (pr == NULL) {
+        return NULL;
+    }
+    pr->lane_count = lanes;
+    pr->schedule_len = total;
+    atomic_store_explicit(&pr->turn, 0, memory_order_relaxed);
+    for (uint32_t i = 0; i < PRIORITY_RING_MAX_LANES; i++) {
+        pr->lanes[i] = NULL;
+    }
+    for (uint32_t i = 0; i < lanes; i++) {
+        pr->lanes[i] = ring_buffer_create(capacity);
+        if (pr->lanes[i] == NULL) {
+            priority_ring_destroy(pr);
+            return NULL;
+        }
+    }
+    if (weights != NULL) {
+        build_schedule(pr, weights);
+    }
+    return pr;
+}
+
+void priority_ring_destroy(PriorityRing *pr) {
+    for (uint32_t i = 0; i < pr->lane_count; i++) {
+        if (pr->lanes[i] != NULL) {
+            ring_buffer_destroy(pr->lanes[i]);
+        }
+    }
+    free(pr);
+}
+
+// --- ENQUEUE ---
+int priority_ring_enqueue(PriorityRing *pr, uint32_t lane, const Event *event) {
+    if (lane >= pr->lane_count) {
+        return -1; // Carril inexistente: 'lanes' solo está lleno hasta lane_count
+    }
+    return enqueue_event(pr->lanes[lane], event);
+}
+
+size_t priority_ring_enqueue_events(PriorityRing *pr, uint32_t lane, const Event *events, size_t count) {
+    if (lane >= pr->lane_count) {
+        return 0;
+    }
+    return enqueue_events(pr->lanes[lane], events, count);
+}
+
+// --- DEQUEUE ---
+// ¿Está publicada la ranura de 'head'? Sin CAS ni cpu_relax, y sin leer 'tail': los
+// carriles vacíos se saltan leyendo líneas que solo escriben los consumidores (y el
+// sello, que ya habrá que leer para extraer).
+static inline int lane_ready(AtomicEventRingBuffer *rb) {
+    uint64_t pos = atomic_load_explicit(&rb->head, memory_order_relaxed);
+    return atomic_load_explicit(&rb->buffer[pos & rb->mask].sequence, memory_order_relaxed) == pos + 1;
+}
+
+size_t priority_ring_dequeue_events(PriorityRing *pr, Event *events, size_t max, uint32_t *lane) {
+    if (max == 0) {
+        return 0;
+    }
+    if (pr->schedule_len != 0) {
+        uint64_t t = atomic_fetch_add_explicit(&pr->turn, 1, memory_order_relaxed);
+        uint32_t turn_lane = pr->schedule[t % pr->schedule_len];
+        if (lane_ready(pr->lanes[turn_lane])) {
+            size_t got = dequeue_events(pr->lanes[turn_lane], events, max);
+            if (got > 0) {
+                if (lane != NULL) {
+                    *lane = turn_lane;
+                }
+                return got;
+            }
+        }
+    }
+    // Modo estricto, o el carril del turno está vacío: el más prioritario con eventos.
+    for (uint32_t i = 0; i < pr->lane_count; i++) {
+        if (!lane_ready(pr->lanes[i])) {
+            continue;
+        }
+        size_t got = dequeue_events(pr->lanes[i], events, max);
+        if (got > 0) {
+            if (lane != NULL) {
+                *lane = i;
+            }
+            return got;
+        }
+    }
+    cpu_relax();
+    return 0; // Todos vacíos
+}
+
+int priority_ring_dequeue(PriorityRing *pr, Event *event) {
+    return priority_ring_dequeue_events(pr, event, 1, NULL) == 1 ? 0 : -1;
+}
+
+// --- OCUPACIÓN ---
+uint64_t priority_ring_lane_size(PriorityRing *pr, uint32_t lane) {
+    if (lane >= pr->lane_count) {
+        return 0;
+    }
+    return ring_buffer_size(pr->lanes[lane]);
+}
+
+uint64_t priority_ring_size(PriorityRing *pr) {
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < pr->lane_count; i++) {
+        total += ring_buffer_size(pr->lanes[i]);
+    }
+    return total;
+}
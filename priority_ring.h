@@ -0,0 +1,59 @@
+#ifndef PRIORITY_RING_H
+#define PRIORITY_RING_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "atomic_event_ring_buffer.h"
+
+// --- CARRILES DE PRIORIDAD (PriorityRing) ---
+// Una cola lógica con K carriles, cada uno un ring MPMC independiente: el carril 0 es el
+// más urgente (vCPU bloqueada esperando una página) y los siguientes, cada vez más
+// "bulk" (hints de prefetch). Los productores eligen carril; los urgentes no esperan
+// detrás de miles de eventos bulk. El orden se conserva dentro de un carril.
+// Consumo:
+//   estricto:  siempre el carril más prioritario con eventos (uno bulk puede esperar
+//              indefinidamente mientras lleguen urgentes).
+//   ponderado: turnos con round-robin ponderado suave. Cada carril i recibe 'weights[i]'
+//              de cada W = suma de pesos turnos, repartidos (no en ráfaga), así que con
+//              eventos pendientes espera como mucho W - weights[i] extracciones. Un
+//              turno de un carril vacío pasa al carril más prioritario con eventos.
+// Mirar si un carril tiene eventos es leer 'head' y el sello de su ranura: saltar los
+// carriles vacíos no toca las líneas de los productores.
+
+#define PRIORITY_RING_MAX_LANES 8
+#define PRIORITY_RING_MAX_SCHEDULE 1024 // Suma máxima de pesos
+
+typedef struct {
+    uint32_t lane_count;
+    uint32_t schedule_len; // W; 0 en modo estricto
+    AtomicEventRingBuffer *lanes[PRIORITY_RING_MAX_LANES]; // Cada uno en su propia reserva
+    // Modo ponderado: turno global de los consumidores (un fetch_add relaxed por extracción).
+    ALIGNED(CACHE_LINE_SIZE) atomic_uint_least64_t turn;
+    ALIGNED(CACHE_LINE_SIZE) uint8_t schedule[]; // Carril de cada turno
+} PriorityRing;
+
+// Crea 'lanes' carriles de 'capacity' ranuras (misma regla que ring_buffer_create).
+// 'weights' NULL: modo estricto; si no, 'lanes' pesos >= 1 que suman como mucho
+// PRIORITY_RING_MAX_SCHEDULE. Retorna NULL si algo no es válido o falla una reserva.
+PriorityRing *priority_ring_create(uint32_t lanes, uint64_t capacity, const uint32_t *weights);
+void priority_ring_destroy(PriorityRing *pr);
+
+// Encola en el carril 'lane'. Igual que enqueue_event/enqueue_events: 0/-1 y número de
+// eventos añadidos; un carril lleno no desborda a otro. Con 'lane' >= lane_count no
+// encola nada (-1 / 0).
+int priority_ring_enqueue(PriorityRing *pr, uint32_t lane, const Event *event);
+size_t priority_ring_enqueue_events(PriorityRing *pr, uint32_t lane, const Event *events, size_t count);
+
+// Extrae según el modo. Igual que dequeue_event: 0 o -1 si todos los carriles están
+// vacíos. La versión por lotes saca hasta 'max' eventos de un solo carril (el que toca)
+// y deja en '*lane' (si no es NULL) de cuál.
+int priority_ring_dequeue(PriorityRing *pr, Event *event);
+size_t priority_ring_dequeue_events(PriorityRing *pr, Event *events, size_t max, uint32_t *lane);
+
+// Ocupación aproximada de un carril (0 si no existe) y del total (solo leen head/tail).
+uint64_t priority_ring_lane_size(PriorityRing *pr, uint32_t lane);
+uint64_t priority_ring_size(PriorityRing *pr);
+
+#endif // PRIORITY_RING_H
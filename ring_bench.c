@@ -0,0 +1,619 @@
+#define _GNU_SOURCE // pthread_setaffinity_np, getopt
+#include <inttypes.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "atomic_event_ring_buffer.h"
+#include "event_ring_variants.h"
+#include "ring_set.h"
+#include "typed_ring.h"
+
+// --- BENCHMARK DE THROUGHPUT Y LATENCIA ---
+// Recorre todas las combinaciones de tipo de ring, productores, consumidores, capacidad
+// y tamaño de lote, y por cada una reporta Mops/s y la latencia enqueue->dequeue
+// (p50/p99/p99.9/max) en CSV o JSON.
+//
+// Latencia: el productor sella un evento de cada 'sample_rate' justo antes de
+// encolarlo (en un array propio indexado por vpn, que viaja dentro del evento) y el
+// consumidor calcula la diferencia al extraerlo. La publicación del ring ordena la
+// escritura del sello antes de la lectura del consumidor.
+//
+// Con -w los hilos usan enqueue_event_wait/dequeue_event_wait (solo MPMC, lote 1), como
+// el test de estrés de main.c: '-w -p 8 -c 2' es su carga.
+//
+// 'set' es un RingSet con un shard por productor (cada productor escribe en el suyo) y
+// consumidores que roban en round-robin; cada shard tiene la capacidad pedida.
+//
+// 'typed' son rings de DECLARE_RING con elementos de 8, 16, 64 o 256 bytes (el Event al
+// principio y relleno): -e elige los tamaños. Su capacidad es fija en compilación, así
+// que solo corren con -s 1024 y 65536. Los demás rings solo tienen elementos de 8 bytes.
+//
+// Uso: ./ring_bench [-r mpmc,spsc,mpsc,spmc,set,typed] [-p 1,2,4,8] [-c 1,2]
+//                   [-s 1024,65536] [-b 1,16,64] [-e 8,16,64,256]
+//                   [-n eventos_por_productor] [-l sample_rate]
+//                   [-a cpu,cpu,...] [-f csv|json] [-w]
+
+#define MAX_LIST 16
+#define MAX_THREADS 256
+#define MAX_BATCH 4096
+#define CONSUMER_WAIT_NS 1000000 // Espera máxima de un consumidor con -w antes de mirar si acabó
+
+typedef struct {
+    int values[MAX_LIST];
+    int count;
+} IntList;
+
+// --- TIPOS DE RING ---
+// Envoltorios con la misma firma para poder elegir el ring en tiempo de ejecución.
+typedef struct {
+    const char *name;
+    int max_producers; // 0 = sin límite
+    int max_consumers;
+    void *(*create)(uint64_t capacity);
+    void (*destroy)(void *rb);
+    size_t (*enqueue)(void *rb, const Event *events, size_t count);
+    size_t (*dequeue)(void *rb, Event *events, size_t max);
+    // Versiones bloqueantes (-w); NULL si el ring no las tiene.
+    int (*enqueue_wait)(void *rb, const Event *event, int64_t timeout_ns);
+    int (*dequeue_wait)(void *rb, Event *event, int64_t timeout_ns);
+    size_t event_bytes;     // Tamaño de elemento del ring
+    uint64_t fixed_capacity; // Capacidad fijada en compilación; 0 = la de -s
+} RingKind;
+
+#define RING_KIND_WRAPPERS(prefix, type, create_fn, destroy_fn)                              \
+    static void *prefix##_create(uint64_t capacity) { return create_fn(capacity); }          \
+    static void prefix##_destroy(void *rb) { destroy_fn((type *)rb); }                       \
+    static size_t prefix##_enqueue(void *rb, const Event *events, size_t count) {            \
+        return count == 1 ? (size_t)(prefix##_enqueue_event((type *)rb, events) == 0)       \
+                          : prefix##_enqueue_events((type *)rb, events, count);              \
+    }                                                                                        \
+    static size_t prefix##_dequeue(void *rb, Event *events, size_t max) {                    \
+        return max == 1 ? (size_t)(prefix##_dequeue_event((type *)rb, events) == 0)         \
+                        : prefix##_dequeue_events((type *)rb, events, max);                  \
+    }
+
+// El MPMC no lleva prefijo en su API.
+#define mpmc_enqueue_event enqueue_event
+#define mpmc_enqueue_events enqueue_events
+#define mpmc_dequeue_event dequeue_event
+#define mpmc_dequeue_events dequeue_events
+
+RING_KIND_WRAPPERS(mpmc, AtomicEventRingBuffer, ring_buffer_create, ring_buffer_destroy)
+RING_KIND_WRAPPERS(spsc, SpscEventRingBuffer, spsc_ring_buffer_create, spsc_ring_buffer_destroy)
+RING_KIND_WRAPPERS(mpsc, MpscEventRingBuffer, mpsc_ring_buffer_create, mpsc_ring_buffer_destroy)
+RING_KIND_WRAPPERS(spmc, SpmcEventRingBuffer, spmc_ring_buffer_create, spmc_ring_buffer_destroy)
+
+static int mpmc_enqueue_wait(void *rb, const Event *event, int64_t timeout_ns) {
+    return enqueue_event_wait((AtomicEventRingBuffer *)rb, event, timeout_ns);
+}
+
+static int mpmc_dequeue_wait(void *rb, Event *event, int64_t timeout_ns) {
+    return dequeue_event_wait((AtomicEventRingBuffer *)rb, event, timeout_ns);
+}
+
+// RingSet: el shard (productor) o la casa (consumidor) es el índice del hilo.
+static _Thread_local uint32_t bench_thread_index;
+static uint32_t bench_shards;
+
+static void *set_create(uint64_t capacity) {
+    return ring_set_create(bench_shards, capacity, RING_SET_STEAL_ROUND_ROBIN);
+}
+
+static void set_destroy(void *rb) {
+    ring_set_destroy((RingSet *)rb);
+}
+
+static size_t set_enqueue(void *rb, const Event *events, size_t count) {
+    return ring_set_enqueue_events((RingSet *)rb, bench_thread_index, events, count);
+}
+
+static size_t set_dequeue(void *rb, Event *events, size_t max) {
+    return ring_set_dequeue_events((RingSet *)rb, bench_thread_index, events, max);
+}
+
+// Rings tipados: un elemento de S bytes con el Event al principio. Cada hilo convierte
+// sus Event en/desde un lote propio (a cero salvo el Event) de como mucho TYPED_CHUNK.
+#define TYPED_CHUNK 64
+
+typedef struct {
+    Event event;
+} BenchEvent8;
+
+#define BENCH_EVENT(S)                               \
+    typedef struct {                                 \
+        Event event;                                 \
+        uint8_t payload[(S) - sizeof(Event)];        \
+    } BenchEvent##S;                                 \
+    _Static_assert(sizeof(BenchEvent##S) == (S), "relleno inesperado en BenchEvent" #S);
+
+BENCH_EVENT(16)
+BENCH_EVENT(64)
+BENCH_EVENT(256)
+
+#define TYPED_KIND_WRAPPERS(name, T)                                                          \
+    static void *name##_bench_create(uint64_t capacity) {                                    \
+        (void)capacity;                                                                       \
+        return name##_create();                                                               \
+    }                                                                                         \
+    static void name##_bench_destroy(void *rb) { name##_destroy((name *)rb); }                \
+    static size_t name##_bench_enqueue(void *rb, const Event *events, size_t count) {        \
+        static _Thread_local T chunk[TYPED_CHUNK];                                            \
+        size_t n = count < TYPED_CHUNK ? count : TYPED_CHUNK;                                 \
+        for (size_t i = 0; i < n; i++) {                                                      \
+            chunk[i].event = events[i];                                                       \
+        }                                                                                     \
+        return n == 1 ? (size_t)(name##_enqueue((name *)rb, chunk) == 0)                      \
+                      : name##_enqueue_batch((name *)rb, chunk, n);                           \
+    }                                                                                         \
+    static size_t name##_bench_dequeue(void *rb, Event *events, size_t max) {                \
+        static _Thread_local T chunk[TYPED_CHUNK];                                            \
+        size_t want = max < TYPED_CHUNK ? max : TYPED_CHUNK;                                  \
+        size_t n = want == 1 ? (size_t)(name##_dequeue((name *)rb, chunk) == 0)               \
+                             : name##_dequeue_batch((name *)rb, chunk, want);                 \
+        for (size_t i = 0; i < n; i++) {                                                      \
+            events[i] = chunk[i].event;                                                       \
+        }                                                                                     \
+        return n;                                                                             \
+    }
+
+#define TYPED_KIND(S, N)                                                                      \
+    DECLARE_RING(TypedRing##S##_##N, BenchEvent##S, N)                                        \
+    TYPED_KIND_WRAPPERS(TypedRing##S##_##N, BenchEvent##S)
+
+#define TYPED_KIND_ENTRY(S, N)                                                                \
+    { "typed", 0, 0, TypedRing##S##_##N##_bench_create, TypedRing##S##_##N##_bench_destroy,   \
+      TypedRing##S##_##N##_bench_enqueue, TypedRing##S##_##N##_bench_dequeue, NULL, NULL, S, N }
+
+TYPED_KIND(8, 1024)
+TYPED_KIND(16, 1024)
+TYPED_KIND(64, 1024)
+TYPED_KIND(256, 1024)
+TYPED_KIND(8, 65536)
+TYPED_KIND(16, 65536)
+TYPED_KIND(64, 65536)
+TYPED_KIND(256, 65536)
+
+static const RingKind ring_kinds[] = {
+    { "mpmc", 0, 0, mpmc_create, mpmc_destroy, mpmc_enqueue, mpmc_dequeue, mpmc_enqueue_wait, mpmc_dequeue_wait, sizeof(Event), 0 },
+    { "spsc", 1, 1, spsc_create, spsc_destroy, spsc_enqueue, spsc_dequeue, NULL, NULL, sizeof(Event), 0 },
+    { "mpsc", 0, 1, mpsc_create, mpsc_destroy, mpsc_enqueue, mpsc_dequeue, NULL, NULL, sizeof(Event), 0 },
+    { "spmc", 1, 0, spmc_create, spmc_destroy, spmc_enqueue, spmc_dequeue, NULL, NULL, sizeof(Event), 0 },
+    { "set", 0, 0, set_create, set_destroy, set_enqueue, set_dequeue, NULL, NULL, sizeof(Event), 0 },
+    TYPED_KIND_ENTRY(8, 1024),
+    TYPED_KIND_ENTRY(16, 1024),
+    TYPED_KIND_ENTRY(64, 1024),
+    TYPED_KIND_ENTRY(256, 1024),
+    TYPED_KIND_ENTRY(8, 65536),
+    TYPED_KIND_ENTRY(16, 65536),
+    TYPED_KIND_ENTRY(64, 65536),
+    TYPED_KIND_ENTRY(256, 65536),
+};
+#define NUM_RING_KINDS (sizeof(ring_kinds) / sizeof(ring_kinds[0]))
+
+// --- CONFIGURACIÓN DE UNA EJECUCIÓN ---
+typedef struct {
+    const RingKind *kind;
+    void *rb;
+    int producers;
+    int consumers;
+    uint64_t capacity;
+    size_t batch;
+    long events_per_producer;
+    long sample_rate;
+    int blocking; // -w: enqueue_wait/dequeue_wait en lugar de reintentar con sched_yield
+} BenchRun;
+
+typedef struct {
+    ALIGNED(CACHE_LINE_SIZE) BenchRun *run;
+    int index;
+    int cpu;              // -1 = sin fijar
+    uint64_t *stamps;     // Productor: sello de cada evento muestreado
+    uint64_t *latencies;  // Consumidor: latencias medidas (ns)
+    size_t latency_count;
+    size_t latency_capacity;
+    long consumed;
+} BenchThread;
+
+static BenchThread threads[MAX_THREADS];
+static uint64_t *producer_stamps[MAX_THREADS]; // Vista de los consumidores sobre los sellos
+static pthread_barrier_t start_barrier;
+static atomic_int producers_finished;
+
+static IntList cpu_list;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void pin_to_cpu(int cpu) {
+    if (cpu < 0) {
+        return;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+        fprintf(stderr, "ring_bench: no se pudo fijar el hilo a la CPU %d\n", cpu);
+    }
+}
+
+// --- PRODUCTOR ---
+static void *producer_thread(void *arg) {
+    BenchThread *self = arg;
+    BenchRun *run = self->run;
+    Event batch[MAX_BATCH];
+
+    pin_to_cpu(self->cpu);
+    bench_thread_index = (uint32_t)self->index;
+    pthread_barrier_wait(&start_barrier);
+
+    long sent = 0;
+    while (sent < run->events_per_producer) {
+        size_t want = run->batch;
+        if ((long)want > run->events_per_producer - sent) {
+            want = (size_t)(run->events_per_producer - sent);
+        }
+
+        // Se sella justo antes de cada intento: se mide el tiempo dentro del ring.
+        uint64_t stamp = now_ns();
+        for (size_t i = 0; i < want; i++) {
+            long seq = sent + (long)i;
+            batch[i].pid = (uint32_t)self->index;
+            batch[i].vpn = (uint32_t)seq;
+            if (seq % run->sample_rate == 0) {
+                self->stamps[seq / run->sample_rate] = stamp;
+            }
+        }
+
+        size_t done;
+        if (run->blocking) {
+            done = run->kind->enqueue_wait(run->rb, batch, -1) == 0; // Lote 1
+        } else {
+            done = run->kind->enqueue(run->rb, batch, want);
+        }
+        if (done == 0) {
+            sched_yield(); // Lleno: cede la CPU a los consumidores
+        }
+        sent += (long)done;
+    }
+
+    atomic_fetch_add(&producers_finished, 1);
+    return NULL;
+}
+
+// --- CONSUMIDOR ---
+static void *consumer_thread(void *arg) {
+    BenchThread *self = arg;
+    BenchRun *run = self->run;
+    Event batch[MAX_BATCH];
+
+    pin_to_cpu(self->cpu);
+    bench_thread_index = (uint32_t)self->index;
+    pthread_barrier_wait(&start_barrier);
+
+    for (;;) {
+        // Se lee antes del dequeue: si todos terminaron y el ring está vacío, no queda nada.
+        int producers_done = atomic_load(&producers_finished) == run->producers;
+        size_t done;
+        if (run->blocking) {
+            done = run->kind->dequeue_wait(run->rb, batch, CONSUMER_WAIT_NS) == 0;
+        } else {
+            done = run->kind->dequeue(run->rb, batch, run->batch);
+        }
+
+        if (done == 0) {
+            if (producers_done) {
+                break;
+            }
+            sched_yield(); // Vacío: cede la CPU a los productores
+            continue;
+        }
+
+        uint64_t now = 0;
+        for (size_t i = 0; i < done; i++) {
+            if (batch[i].vpn % run->sample_rate != 0) {
+                continue;
+            }
+            if (now == 0) {
+                now = now_ns();
+            }
+            uint64_t stamp = producer_stamps[batch[i].pid][batch[i].vpn / run->sample_rate];
+            if (self->latency_count < self->latency_capacity) {
+                self->latencies[self->latency_count++] = now - stamp;
+            }
+        }
+        self->consumed += (long)done;
+    }
+    return NULL;
+}
+
+// --- PERCENTILES ---
+static int compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static uint64_t percentile(const uint64_t *sorted, size_t count, double p) {
+    if (count == 0) {
+        return 0;
+    }
+    size_t index = (size_t)(p * (double)(count - 1) + 0.5);
+    return sorted[index];
+}
+
+// --- SALIDA ---
+static int output_json;
+static int results_printed;
+static int stats_enabled; // Biblioteca compilada con RING_STATS: columnas de contención
+
+static void print_header(void) {
+    if (output_json) {
+        printf("[\n");
+    } else {
+        printf("ring,producers,consumers,capacity,batch,event_bytes,events,seconds,mops,"
+               "p50_ns,p99_ns,p999_ns,max_ns,cpus_pinned%s\n",
+               stats_enabled ? ",tail_cas_failures,head_cas_failures,enqueue_full,dequeue_empty" : "");
+    }
+}
+
+// 'stats' son los contadores de contención de esta ejecución, o NULL sin RING_STATS.
+static void print_result(const BenchRun *run, long events, double seconds,
+                         const uint64_t *sorted, size_t samples, const RingStats *stats) {
+    double mops = (double)events / seconds / 1e6;
+    uint64_t p50 = percentile(sorted, samples, 0.50);
+    uint64_t p99 = percentile(sorted, samples, 0.99);
+    uint64_t p999 = percentile(sorted, samples, 0.999);
+    uint64_t max = samples > 0 ? sorted[samples - 1] : 0;
+
+    if (output_json) {
+        printf("%s  {\"ring\": \"%s\", \"producers\": %d, \"consumers\": %d, \"capacity\": %" PRIu64
+               ", \"batch\": %zu, \"event_bytes\": %zu, \"events\": %ld, \"seconds\": %.6f, \"mops\": %.3f"
+               ", \"p50_ns\": %" PRIu64 ", \"p99_ns\": %" PRIu64 ", \"p999_ns\": %" PRIu64
+               ", \"max_ns\": %" PRIu64 ", \"cpus_pinned\": %d",
+               results_printed ? ",\n" : "", run->kind->name, run->producers, run->consumers,
+               run->capacity, run->batch, run->kind->event_bytes, events, seconds, mops, p50, p99, p999, max,
+               cpu_list.count > 0);
+        if (stats != NULL) {
+            printf(", \"tail_cas_failures\": %" PRIu64 ", \"head_cas_failures\": %" PRIu64
+                   ", \"enqueue_full\": %" PRIu64 ", \"dequeue_empty\": %" PRIu64,
+                   stats->tail_cas_failures, stats->head_cas_failures, stats->enqueue_full, stats->dequeue_empty);
+        }
+        printf("}");
+    } else {
+        printf("%s,%d,%d,%" PRIu64 ",%zu,%zu,%ld,%.6f,%.3f,%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%d",
+               run->kind->name, run->producers, run->consumers, run->capacity, run->batch,
+               run->kind->event_bytes, events, seconds, mops, p50, p99, p999, max, cpu_list.count > 0);
+        if (stats != NULL) {
+            printf(",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64, stats->tail_cas_failures,
+                   stats->head_cas_failures, stats->enqueue_full, stats->dequeue_empty);
+        }
+        printf("\n");
+    }
+    results_printed++;
+    fflush(stdout);
+}
+
+static void print_footer(void) {
+    if (output_json) {
+        printf("\n]\n");
+    }
+}
+
+// --- UNA EJECUCIÓN ---
+static int run_one(BenchRun *run) {
+    int total = run->producers + run->consumers;
+    size_t samples_per_producer = (size_t)(run->events_per_producer / run->sample_rate) + 1;
+    size_t samples_total = samples_per_producer * (size_t)run->producers;
+
+    bench_shards = (uint32_t)run->producers;
+    run->rb = run->kind->create(run->capacity);
+    if (run->rb == NULL) {
+        fprintf(stderr, "ring_bench: no se pudo crear el ring %s de %" PRIu64 " ranuras\n",
+                run->kind->name, run->capacity);
+        return -1;
+    }
+
+    memset(threads, 0, sizeof(threads));
+    atomic_store(&producers_finished, 0);
+    pthread_barrier_init(&start_barrier, NULL, (unsigned)total + 1);
+
+    RingStats before, after;
+    ring_stats_snapshot(&before);
+
+    pthread_t tids[MAX_THREADS];
+    for (int i = 0; i < total; i++) {
+        BenchThread *t = &threads[i];
+        int producer = i < run->producers;
+        t->run = run;
+        t->index = producer ? i : i - run->producers;
+        t->cpu = cpu_list.count > 0 ? cpu_list.values[i % cpu_list.count] : -1;
+        if (producer) {
+            t->stamps = calloc(samples_per_producer, sizeof(uint64_t));
+            producer_stamps[i] = t->stamps;
+        } else {
+            t->latency_capacity = samples_total;
+            t->latencies = malloc(samples_total * sizeof(uint64_t));
+        }
+        if ((producer && t->stamps == NULL) || (!producer && t->latencies == NULL)) {
+            fprintf(stderr, "ring_bench: sin memoria para las muestras\n");
+            exit(1);
+        }
+    }
+    for (int i = 0; i < total; i++) {
+        pthread_create(&tids[i], NULL, i < run->producers ? producer_thread : consumer_thread, &threads[i]);
+    }
+
+    pthread_barrier_wait(&start_barrier);
+    uint64_t start = now_ns();
+    for (int i = 0; i < total; i++) {
+        pthread_join(tids[i], NULL);
+    }
+    double seconds = (double)(now_ns() - start) / 1e9;
+
+    // Los contadores son acumulados del proceso: esta ejecución es la diferencia.
+    ring_stats_snapshot(&after);
+    after.tail_cas_failures -= before.tail_cas_failures;
+    after.head_cas_failures -= before.head_cas_failures;
+    after.enqueue_full -= before.enqueue_full;
+    after.dequeue_empty -= before.dequeue_empty;
+
+    // Junta las latencias de todos los consumidores.
+    uint64_t *all = malloc(samples_total * sizeof(uint64_t));
+    size_t samples = 0;
+    long consumed = 0;
+    for (int i = run->producers; i < total; i++) {
+        memcpy(all + samples, threads[i].latencies, threads[i].latency_count * sizeof(uint64_t));
+        samples += threads[i].latency_count;
+        consumed += threads[i].consumed;
+        free(threads[i].latencies);
+    }
+    for (int i = 0; i < run->producers; i++) {
+        free(threads[i].stamps);
+    }
+    qsort(all, samples, sizeof(uint64_t), compare_u64);
+
+    long expected = run->events_per_producer * run->producers;
+    if (consumed != expected) {
+        fprintf(stderr, "ring_bench: %s consumió %ld de %ld eventos\n", run->kind->name, consumed, expected);
+    }
+    print_result(run, consumed, seconds, all, samples, stats_enabled ? &after : NULL);
+
+    free(all);
+    pthread_barrier_destroy(&start_barrier);
+    run->kind->destroy(run->rb);
+    return 0;
+}
+
+// --- ARGUMENTOS ---
+static int parse_list(const char *arg, IntList *list) {
+    char *copy = strdup(arg);
+    char *save = NULL;
+    list->count = 0;
+    for (char *tok = strtok_r(copy, ",", &save); tok != NULL; tok = strtok_r(NULL, ",", &save)) {
+        if (list->count == MAX_LIST) {
+            free(copy);
+            return -1;
+        }
+        list->values[list->count++] = atoi(tok);
+    }
+    free(copy);
+    return list->count > 0 ? 0 : -1;
+}
+
+static int list_contains(const IntList *list, int value) {
+    for (int i = 0; i < list->count; i++) {
+        if (list->values[i] == value) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "uso: %s [-r mpmc,spsc,mpsc,spmc,set,typed] [-p productores,...] [-c consumidores,...]\n"
+            "          [-s capacidad,...] [-b lote,...] [-e bytes_por_evento,...] [-n eventos_por_productor]\n"
+            "          [-l muestrear_1_de_N] [-a cpu,...] [-f csv|json] [-w]\n",
+            prog);
+}
+
+int main(int argc, char **argv) {
+    const char *kinds_arg = "mpmc";
+    IntList producers = { { 1, 2, 4, 8 }, 4 };
+    IntList consumers = { { 1, 2 }, 2 };
+    IntList capacities = { { 1024, 65536 }, 2 };
+    IntList batches = { { 1, 16, 64 }, 3 };
+    IntList event_sizes = { { 8 }, 1 };
+    long events_per_producer = 200000;
+    long sample_rate = 64;
+    int blocking = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "r:p:c:s:b:e:n:l:a:f:wh")) != -1) {
+        int bad = 0;
+        switch (opt) {
+        case 'r': kinds_arg = optarg; break;
+        case 'p': bad = parse_list(optarg, &producers); break;
+        case 'c': bad = parse_list(optarg, &consumers); break;
+        case 's': bad = parse_list(optarg, &capacities); break;
+        case 'b': bad = parse_list(optarg, &batches); break;
+        case 'e': bad = parse_list(optarg, &event_sizes); break;
+        case 'n': events_per_producer = atol(optarg); break;
+        case 'l': sample_rate = atol(optarg); break;
+        case 'a': bad = parse_list(optarg, &cpu_list); break;
+        case 'w': blocking = 1; break;
+        case 'f':
+            if (strcmp(optarg, "json") == 0) {
+                output_json = 1;
+            } else if (strcmp(optarg, "csv") != 0) {
+                bad = 1;
+            }
+            break;
+        default: bad = 1; break;
+        }
+        if (bad) {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (events_per_producer < 1 || sample_rate < 1 || events_per_producer > UINT32_MAX) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    RingStats probe;
+    stats_enabled = ring_stats_snapshot(&probe) == 0;
+
+    print_header();
+    for (size_t k = 0; k < NUM_RING_KINDS; k++) {
+        const RingKind *kind = &ring_kinds[k];
+        if (strstr(kinds_arg, kind->name) == NULL || (blocking && kind->enqueue_wait == NULL) ||
+            !list_contains(&event_sizes, (int)kind->event_bytes)) {
+            continue;
+        }
+        for (int p = 0; p < producers.count; p++) {
+            for (int c = 0; c < consumers.count; c++) {
+                int np = producers.values[p];
+                int nc = consumers.values[c];
+                // Combinaciones que el tipo de ring no admite (p. ej. SPSC con 8 productores).
+                if (np < 1 || nc < 1 || np + nc > MAX_THREADS ||
+                    (kind->max_producers && np > kind->max_producers) ||
+                    (kind->max_consumers && nc > kind->max_consumers)) {
+                    continue;
+                }
+                for (int s = 0; s < capacities.count; s++) {
+                    for (int b = 0; b < batches.count; b++) {
+                        if (capacities.values[s] < 1 || batches.values[b] < 1 || batches.values[b] > MAX_BATCH ||
+                            (blocking && batches.values[b] != 1) ||
+                            (kind->fixed_capacity && (uint64_t)capacities.values[s] != kind->fixed_capacity)) {
+                            continue;
+                        }
+                        BenchRun run = {
+                            .kind = kind,
+                            .producers = np,
+                            .consumers = nc,
+                            .capacity = (uint64_t)capacities.values[s],
+                            .batch = (size_t)batches.values[b],
+                            .events_per_producer = events_per_producer,
+                            .sample_rate = sample_rate,
+                            .blocking = blocking,
+                        };
+                        run_one(&run);
+                    }
+                }
+            }
+        }
+    }
+    print_footer();
+    return 0;
+}
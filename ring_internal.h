@@ -0,0 +1,330 @@
+#ifndef RING_INTERNAL_H
+#define RING_INTERNAL_H
+
+// --- UTILIDADES INTERNAS ---
+// Piezas compartidas por las implementaciones de ring (MPMC, SPSC, MPSC, SPMC...).
+// No forma parte del API público: solo lo incluyen los .c de la biblioteca.
+
+#include <linux/futex.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "atomic_event_ring_buffer.h"
+
+// Valor de 'sequence - pos' con el que una ranura está lista para cada lado.
+#define SLOT_LAG_PRODUCER 0 // Ranura libre para el productor de 'pos'
+#define SLOT_LAG_CONSUMER 1 // Ranura publicada para el consumidor de 'pos'
+
+// --- TRAZAS ---
+// Mensajes informativos de la biblioteca. Van a stderr para no mezclarse con la salida
+// de los programas que la usan (p. ej. el CSV/JSON de ring_bench).
+#define ring_log(...) fprintf(stderr, __VA_ARGS__)
+
+// --- CONTADORES DE UN SOLO ESCRITOR ---
+// Los escribe un único hilo y otros los leen a la vez: load + store relaxed, sin RMW
+// (en x86 son un mov normal, sin lock).
+static inline void ring_counter_add(atomic_uint_least64_t *counter, uint64_t v) {
+    atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + v,
+                          memory_order_relaxed);
+}
+
+// --- CONTADORES DE CONTENCIÓN (RING_STATS) ---
+// Bloque por hilo, reservado en su primer uso y enlazado en una lista global que
+// recorre ring_stats_snapshot. Sin RING_STATS, RING_STAT_ADD no genera código.
+#ifdef RING_STATS
+typedef struct RingStatsBlock {
+    ALIGNED(CACHE_LINE_SIZE) atomic_uint_least64_t enqueue_ok;
+    atomic_uint_least64_t enqueue_full;
+    atomic_uint_least64_t tail_cas_failures;
+    atomic_uint_least64_t dequeue_ok;
+    atomic_uint_least64_t dequeue_empty;
+    atomic_uint_least64_t head_cas_failures;
+    atomic_uint_least64_t wait_spins;
+    atomic_uint_least64_t wait_parks;
+    struct RingStatsBlock *next;
+} RingStatsBlock;
+
+extern _Thread_local RingStatsBlock *ring_stats_tls;
+RingStatsBlock *ring_stats_register(void);
+
+static inline RingStatsBlock *ring_stats_local(void) {
+    RingStatsBlock *block = ring_stats_tls;
+    return block != NULL ? block : ring_stats_register();
+}
+
+#define RING_STAT_ADD(field, n) ring_counter_add(&ring_stats_local()->field, (n))
+#else
+#define RING_STAT_ADD(field, n) ((void)0)
+#endif
+
+// Contadores del lado que indica 'lag' (productores en 'tail', consumidores en 'head').
+#define RING_STAT_SIDE(lag, producer_field, consumer_field, n)                  \
+    do {                                                                       \
+        if ((lag) == SLOT_LAG_PRODUCER) {                                      \
+            RING_STAT_ADD(producer_field, n);                                  \
+        } else {                                                               \
+            RING_STAT_ADD(consumer_field, n);                                  \
+        }                                                                      \
+    } while (0)
+
+// --- PAUSA EN SPIN-WAIT ---
+// La instrucción PAUSE (__builtin_ia32_pause) en CPUs Intel/AMD reduce el consumo de energía en spin-waits.
+static inline void cpu_relax(void) {
+#ifdef __x86_64__
+    __builtin_ia32_pause();
+#endif
+}
+
+// --- FUTEX ---
+// Envoltorios mínimos sobre la syscall (glibc no expone futex()). Requieren _GNU_SOURCE.
+_Static_assert(sizeof(atomic_uint_least32_t) == sizeof(uint32_t), "el futex debe ser de 32 bits");
+
+// Los rings de un solo proceso usan las variantes _PRIVATE (más baratas en el kernel);
+// los de memoria compartida necesitan las normales, indexadas por página física.
+
+// Duerme mientras '*addr' valga 'expected'. 'timeout' es relativo; NULL espera sin límite.
+static inline void futex_wait(atomic_uint_least32_t *addr, uint32_t expected,
+                              const struct timespec *timeout, int shared) {
+    syscall(SYS_futex, addr, shared ? FUTEX_WAIT : FUTEX_WAIT_PRIVATE, expected, timeout, NULL, 0);
+}
+
+static inline void futex_wake(atomic_uint_least32_t *addr, int count, int shared) {
+    syscall(SYS_futex, addr, shared ? FUTEX_WAKE : FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+}
+
+static inline uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Redondea hacia arriba a la siguiente potencia de dos.
+static inline uint64_t round_up_pow2(uint64_t v) {
+    v--;
+    v |= v >> 1;
+    v |= v >> 2;
+    v |= v >> 4;
+    v |= v >> 8;
+    v |= v >> 16;
+    v |= v >> 32;
+    return v + 1;
+}
+
+// Capacidad efectiva para una capacidad pedida, o 0 si no es válida.
+// Con una sola ranura "publicada" (pos + 1) y "liberada" (pos + capacity)
+// serían el mismo sello, así que el mínimo es 2.
+static inline uint64_t ring_normalize_capacity(uint64_t capacity) {
+    if (capacity == 0 || capacity > RING_MAX_CAPACITY) {
+        return 0;
+    }
+    return capacity < 2 ? 2 : round_up_pow2(capacity);
+}
+
+// Reserva alineada a línea de caché para cabecera + ranuras.
+// aligned_alloc exige que el tamaño sea múltiplo de la alineación.
+static inline void *ring_alloc(size_t bytes) {
+    bytes = (bytes + CACHE_LINE_SIZE - 1) & ~(size_t)(CACHE_LINE_SIZE - 1);
+    return aligned_alloc(CACHE_LINE_SIZE, bytes);
+}
+
+// Cada ranura arranca libre para la posición que le corresponde en la primera vuelta.
+static inline void ring_init_slots(EventSlot *buffer, uint64_t capacity) {
+    for (uint64_t i = 0; i < capacity; i++) {
+        atomic_store_explicit(&buffer[i].sequence, i, memory_order_relaxed);
+    }
+}
+
+// --- RESERVA DE UNA RANURA (lado contendido) ---
+// Reclama con CAS sobre 'counter' la siguiente posición cuya ranura esté lista para
+// este lado ('lag'). Un productor no necesita leer 'head' ni un consumidor 'tail':
+// el sello de la ranura dice si está libre o publicada.
+// El CAS es seq_cst: la espera bloqueante (dequeue_event_wait) se apoya en que el
+// avance de 'tail' quede ordenado antes de la lectura de los contadores de espera.
+// En x86 es la misma instrucción (lock cmpxchg) que con relaxed.
+// Retorna la ranura (y su posición en '*pos_out') o NULL si el buffer está lleno/vacío.
+static inline EventSlot *ring_claim_slot(atomic_uint_least64_t *counter, EventSlot *buffer,
+                                         uint64_t mask, uint64_t lag, uint64_t *pos_out) {
+    uint64_t pos = atomic_load_explicit(counter, memory_order_relaxed);
+
+    for (;;) {
+        EventSlot *slot = &buffer[pos & mask];
+        // acquire: sincroniza con el lado opuesto, que cedió la ranura con release.
+        uint64_t seq = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        int64_t diff = (int64_t)(seq - (pos + lag));
+
+        if (diff == 0) {
+            // La ranura está lista para 'pos': intenta reclamar la posición.
+            // Si el CAS falla, 'pos' se actualiza con el valor actual y se reintenta.
+            if (atomic_compare_exchange_weak_explicit(counter, &pos, pos + 1,
+                                                      memory_order_seq_cst, memory_order_relaxed)) {
+                RING_STAT_SIDE(lag, enqueue_ok, dequeue_ok, 1);
+                *pos_out = pos;
+                return slot;
+            }
+            RING_STAT_SIDE(lag, tail_cas_failures, head_cas_failures, 1);
+        } else if (diff < 0) {
+            // La ranura sigue en manos del otro lado: lleno (productor) o vacío (consumidor).
+            RING_STAT_SIDE(lag, enqueue_full, dequeue_empty, 1);
+            cpu_relax();
+            return NULL;
+        } else {
+            // Otro hilo de este lado ya reclamó 'pos'; relee el contador.
+            pos = atomic_load_explicit(counter, memory_order_relaxed);
+        }
+    }
+}
+
+// Cuenta cuántas ranuras consecutivas desde 'pos' están listas para este lado, hasta 'max'.
+static inline size_t ring_count_ready(EventSlot *buffer, uint64_t mask, uint64_t pos,
+                                      uint64_t lag, size_t max) {
+    size_t n = 0;
+    while (n < max) {
+        uint64_t seq = atomic_load_explicit(&buffer[(pos + n) & mask].sequence, memory_order_acquire);
+        if (seq != pos + n + lag) {
+            break;
+        }
+        n++;
+    }
+    return n;
+}
+
+// --- RESERVA DE UN RANGO (lado contendido) ---
+// Reclama hasta 'max' posiciones contiguas con un solo CAS sobre 'counter'.
+// Primero cuenta cuántas ranuras consecutivas están listas y luego reclama exactamente
+// ese rango, así que nunca incluye una ranura que otro hilo aún posee.
+// Como en ring_claim_slot, el CAS es seq_cst.
+// Retorna el número de posiciones reclamadas (0 si lleno/vacío) y la primera en '*pos_out'.
+static inline size_t ring_claim_range(atomic_uint_least64_t *counter, EventSlot *buffer,
+                                      uint64_t mask, uint64_t lag, size_t max, uint64_t *pos_out) {
+    if (max == 0) {
+        return 0;
+    }
+
+    uint64_t pos = atomic_load_explicit(counter, memory_order_relaxed);
+
+    for (;;) {
+        uint64_t seq = atomic_load_explicit(&buffer[pos & mask].sequence, memory_order_acquire);
+        int64_t diff = (int64_t)(seq - (pos + lag));
+
+        if (diff < 0) {
+            RING_STAT_SIDE(lag, enqueue_full, dequeue_empty, 1);
+            cpu_relax();
+            return 0;
+        }
+        if (diff > 0) {
+            pos = atomic_load_explicit(counter, memory_order_relaxed);
+            continue;
+        }
+
+        // La primera ranura está lista: cuenta las siguientes.
+        size_t n = 1 + ring_count_ready(buffer, mask, pos + 1, lag, max - 1);
+
+        if (atomic_compare_exchange_weak_explicit(counter, &pos, pos + n,
+                                                  memory_order_seq_cst, memory_order_relaxed)) {
+            RING_STAT_SIDE(lag, enqueue_ok, dequeue_ok, n);
+            *pos_out = pos;
+            return n;
+        }
+        RING_STAT_SIDE(lag, tail_cas_failures, head_cas_failures, 1);
+    }
+}
+
+// --- COPIA DE RANGOS ---
+// Copian un rango [pos, pos + n) ya reclamado y ceden cada ranura al otro lado.
+// Primer tramo hasta el final del array, segundo tramo desde el principio si el
+// rango da la vuelta, sin enmascarar dentro de los bucles.
+// ring_release_range con 'events' NULL solo devuelve los sellos (el evento ya se usó en
+// la ranura, como en RingPipeline); al ser inline, la comprobación sale del bucle.
+static inline void ring_publish_range(EventSlot *buffer, uint64_t capacity, uint64_t pos,
+                                      const Event *events, size_t n) {
+    size_t start = pos & (capacity - 1);
+    size_t first = n < capacity - start ? n : capacity - start;
+
+    for (size_t i = 0; i < first; i++) {
+        EventSlot *slot = &buffer[start + i];
+        slot->event = events[i];
+        atomic_store_explicit(&slot->sequence, pos + i + 1, memory_order_release);
+    }
+    for (size_t i = first; i < n; i++) {
+        EventSlot *slot = &buffer[i - first];
+        slot->event = events[i];
+        atomic_store_explicit(&slot->sequence, pos + i + 1, memory_order_release);
+    }
+}
+
+static inline void ring_release_range(EventSlot *buffer, uint64_t capacity, uint64_t pos,
+                                      Event *events, size_t n) {
+    size_t start = pos & (capacity - 1);
+    size_t first = n < capacity - start ? n : capacity - start;
+
+    for (size_t i = 0; i < first; i++) {
+        EventSlot *slot = &buffer[start + i];
+        if (events != NULL) {
+            events[i] = slot->event;
+        }
+        atomic_store_explicit(&slot->sequence, pos + i + capacity, memory_order_release);
+    }
+    for (size_t i = first; i < n; i++) {
+        EventSlot *slot = &buffer[i - first];
+        if (events != NULL) {
+            events[i] = slot->event;
+        }
+        atomic_store_explicit(&slot->sequence, pos + i + capacity, memory_order_release);
+    }
+}
+
+// --- DESPERTAR DESDE OTROS MÓDULOS ---
+// Para consumidores que ceden ranuras de un AtomicEventRingBuffer sin pasar por
+// dequeue_event (RingPipeline): despierta a los productores en enqueue_event_wait.
+// Llamar después de avanzar 'head' con seq_cst y de devolver los sellos.
+void ring_wake_producers(AtomicEventRingBuffer *rb, size_t count);
+
+// --- SELLOS SEQLOCK (modo sobrescritura, broadcast) ---
+// Para rings en los que un productor puede reescribir una ranura mientras alguien la lee:
+//   sequence == 2 * pos + 1       -> el productor de 'pos' está escribiendo la ranura.
+//   sequence == 2 * (pos + 1)     -> publicada para el consumidor de 'pos'.
+// El sello solo crece: un valor mayor siempre es de una vuelta más reciente. El lector
+// copia el evento y, tras un fence acquire, comprueba que el sello no cambió.
+
+// Escribe en 'slot' el evento de la posición 'pos', ya reclamada por este productor.
+static inline void ring_seqlock_publish(EventSlot *slot, uint64_t pos, const Event *event) {
+    uint64_t writing = 2 * pos + 1;
+    uint64_t seq = atomic_load_explicit(&slot->sequence, memory_order_relaxed);
+    unsigned spins = 0;
+
+    for (;;) {
+        if (seq >= writing) {
+            // Un productor de una vuelta posterior ya tomó la ranura: este evento ya es
+            // el más antiguo y se pierde sin escribirlo (quien lo esperaba lo verá saltado).
+            return;
+        }
+        if (seq & 1) {
+            // Un productor de una vuelta anterior sigue escribiendo: hay que esperarle,
+            // o los dos eventos se mezclarían en la ranura.
+            if (++spins % 1024 == 0) {
+                sched_yield();
+            } else {
+                cpu_relax();
+            }
+            seq = atomic_load_explicit(&slot->sequence, memory_order_relaxed);
+            continue;
+        }
+        if (atomic_compare_exchange_weak_explicit(&slot->sequence, &seq, writing,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+            break;
+        }
+    }
+    // Seqlock: el sello impar se ve antes que cualquier byte del evento nuevo.
+    atomic_thread_fence(memory_order_release);
+    slot->event = *event;
+    atomic_store_explicit(&slot->sequence, writing + 1, memory_order_release);
+}
+
+#endif // RING_INTERNAL_H
@@ -0,0 +1,123 @@
+#define _GNU_SOURCE // syscall() del futex en ring_internal.h
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "ring_internal.h"
+#include "ring_pipeline.h"
+
+// --- CREACIÓN / DESTRUCCIÓN ---
+RingPipeline *ring_pipeline_create(AtomicEventRingBuffer *rb) {
+    if (rb->flags & RING_FLAG_OVERWRITE) {
+        return NULL;
+    }
+    RingPipeline *p = ring_alloc(sizeof(RingPipeline));
+    if (p == NULL) {
+        return NULL;
+    }
+    p->rb = rb;
+    p->stage_count = 0;
+    p->terminal = 0;
+    atomic_store_explicit(&p->released, atomic_load_explicit(&rb->head, memory_order_acquire),
+                          memory_order_relaxed);
+    return p;
+}
+
+void ring_pipeline_destroy(RingPipeline *p) {
+    free(p);
+}
+
+int ring_pipeline_add_stage(RingPipeline *p, uint32_t deps) {
+    uint32_t id = p->stage_count;
+    if (id == RING_PIPELINE_MAX_STAGES || (deps >> id) != 0) {
+        return -1;
+    }
+    RingStage *s = &p->stages[id];
+    uint64_t start = atomic_load_explicit(&p->released, memory_order_relaxed);
+    atomic_store_explicit(&s->cursor, start, memory_order_relaxed);
+    s->limit = start;
+    s->deps = deps;
+    // La nueva es final; las que la alimentan dejan de serlo.
+    p->terminal = (p->terminal & ~deps) | (1u << id);
+    p->stage_count = id + 1;
+    return (int)id;
+}
+
+// --- BARRERA DE SECUENCIA ---
+// Hasta dónde puede leer una etapa: lo publicado (sin dependencias) o el mínimo de los
+// cursores de sus dependencias. El acquire empareja con el store-release del cursor:
+// lo que la etapa anterior escribió en la ranura es visible.
+static uint64_t stage_barrier(RingPipeline *p, const RingStage *s, uint64_t pos) {
+    AtomicEventRingBuffer *rb = p->rb;
+    if (s->deps == 0) {
+        return pos + ring_count_ready(rb->buffer, rb->mask, pos, SLOT_LAG_CONSUMER, rb->capacity);
+    }
+    uint64_t limit = 0;
+    int first = 1;
+    for (uint32_t deps = s->deps; deps != 0; deps &= deps - 1) {
+        uint64_t c = atomic_load_explicit(&p->stages[__builtin_ctz(deps)].cursor, memory_order_acquire);
+        if (first || (int64_t)(c - limit) < 0) {
+            limit = c;
+            first = 0;
+        }
+    }
+    return limit;
+}
+
+size_t ring_stage_available(RingPipeline *p, uint32_t stage, uint64_t *pos) {
+    RingStage *s = &p->stages[stage];
+    uint64_t cursor = atomic_load_explicit(&s->cursor, memory_order_relaxed);
+    *pos = cursor;
+    if (s->limit == cursor) {
+        s->limit = stage_barrier(p, s, cursor);
+        if (s->limit == cursor) {
+            cpu_relax();
+        }
+    }
+    return (size_t)(s->limit - cursor);
+}
+
+Event *ring_stage_event(RingPipeline *p, uint64_t pos) {
+    return &p->rb->buffer[pos & p->rb->mask].event;
+}
+
+// --- LIBERACIÓN ---
+// Devuelve a los productores [released, mínimo de las etapas finales). Con varias
+// finales, la que gana el CAS sobre 'released' libera el tramo; los tramos no se solapan.
+static void pipeline_release(RingPipeline *p) {
+    AtomicEventRingBuffer *rb = p->rb;
+    uint64_t min = 0;
+    int first = 1;
+    for (uint32_t t = p->terminal; t != 0; t &= t - 1) {
+        uint64_t c = atomic_load_explicit(&p->stages[__builtin_ctz(t)].cursor, memory_order_acquire);
+        if (first || (int64_t)(c - min) < 0) {
+            min = c;
+            first = 0;
+        }
+    }
+
+    uint64_t done = atomic_load_explicit(&p->released, memory_order_relaxed);
+    while ((int64_t)(min - done) > 0) {
+        if (atomic_compare_exchange_weak_explicit(&p->released, &done, min,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+            // 'head' primero y con seq_cst: un productor en enqueue_event_wait que ya se
+            // registró en 'waiters' ve el hueco (wait_has_pending) o recibe el despertar.
+            atomic_fetch_add_explicit(&rb->head, min - done, memory_order_seq_cst);
+            ring_release_range(rb->buffer, rb->capacity, done, NULL, (size_t)(min - done));
+            ring_wake_producers(rb, (size_t)(min - done));
+            return;
+        }
+    }
+}
+
+void ring_stage_commit(RingPipeline *p, uint32_t stage, size_t n) {
+    RingStage *s = &p->stages[stage];
+    uint64_t cursor = atomic_load_explicit(&s->cursor, memory_order_relaxed);
+    // release: las lecturas y escrituras de la etapa en estas ranuras terminan antes de
+    // que las vea la siguiente etapa (o los productores).
+    atomic_store_explicit(&s->cursor, cursor + n, memory_order_release);
+    if (p->terminal & (1u << stage)) {
+        pipeline_release(p);
+    }
+}
@@ -0,0 +1,63 @@
+#ifndef RING_PIPELINE_H
+#define RING_PIPELINE_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "atomic_event_ring_buffer.h"
+
+// --- ETAPAS ENCADENADAS SOBRE UN RING (RingPipeline) ---
+// validar -> traducir -> aplicar sobre un único AtomicEventRingBuffer, sin copiar cada
+// evento a un ring por etapa. Cada etapa lleva un cursor propio (posiciones terminadas,
+// en su propia línea de caché) y declara de qué etapas depende: su barrera es el mínimo
+// de esos cursores, así que solo lee ranuras que todas ellas ya terminaron (barreras de
+// secuencia al estilo Disruptor). Una etapa sin dependencias lee lo publicado.
+// Las etapas trabajan sobre la ranura (ring_stage_event): pueden modificar el evento y
+// la siguiente etapa ve el cambio. Cuando todas las etapas finales (de las que no
+// depende ninguna) han pasado una ranura, se devuelve a los productores.
+// El pipeline es el único consumidor del ring: no mezclar con dequeue_event/ring_peek.
+// Cada etapa la ejecuta un solo hilo; etapas distintas corren en paralelo. Dos etapas
+// sin dependencia entre ellas ven la misma ranura a la vez: ninguna debe modificar lo
+// que la otra lee.
+
+#define RING_PIPELINE_MAX_STAGES 8
+
+typedef struct {
+    ALIGNED(CACHE_LINE_SIZE) atomic_uint_least64_t cursor; // Siguiente posición sin terminar (escribe solo su hilo)
+    uint64_t limit; // Copia privada de la barrera: hasta dónde puede leer sin releerla
+    uint32_t deps;  // Máscara de etapas de las que depende (0: lee lo publicado)
+} RingStage;
+
+typedef struct {
+    AtomicEventRingBuffer *rb;
+    uint32_t stage_count;
+    uint32_t terminal; // Máscara de etapas de las que no depende ninguna
+    // Posiciones ya devueltas a los productores.
+    ALIGNED(CACHE_LINE_SIZE) atomic_uint_least64_t released;
+    RingStage stages[RING_PIPELINE_MAX_STAGES];
+} RingPipeline;
+
+// Crea un pipeline vacío que consume 'rb' desde su 'head' actual.
+// Retorna NULL si falla la reserva o el ring es RING_FLAG_OVERWRITE (sus ranuras no se
+// pueden retener).
+RingPipeline *ring_pipeline_create(AtomicEventRingBuffer *rb);
+void ring_pipeline_destroy(RingPipeline *p);
+
+// Añade una etapa que depende de las etapas de la máscara 'deps' (bit i = etapa i; 0 si
+// lee directamente lo que publican los productores) y retorna su índice, o -1 si ya hay
+// RING_PIPELINE_MAX_STAGES o 'deps' nombra una etapa que aún no existe (así el grafo
+// queda en orden topológico y sin ciclos). Todas antes de empezar a consumir.
+int ring_pipeline_add_stage(RingPipeline *p, uint32_t deps);
+
+// Barrera de la etapa: cuántas posiciones consecutivas desde '*pos' (su cursor) puede
+// procesar ya. Solo relee los cursores de sus dependencias cuando agota lo último visto.
+size_t ring_stage_available(RingPipeline *p, uint32_t stage, uint64_t *pos);
+// Evento de la posición 'pos' dentro del ring, para leerlo o modificarlo en sitio.
+Event *ring_stage_event(RingPipeline *p, uint64_t pos);
+// Marca como terminadas las 'n' siguientes posiciones de la etapa (n <= lo disponible).
+// Si es una etapa final, devuelve a los productores las ranuras que todas las finales
+// ya pasaron.
+void ring_stage_commit(RingPipeline *p, uint32_t stage, size_t n);
+
+#endif // RING_PIPELINE_H
@@ -0,0 +1,52 @@
+#ifndef RING_SET_H
+#define RING_SET_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "atomic_event_ring_buffer.h"
+
+// --- CONJUNTO DE RINGS FRAGMENTADO (RingSet) ---
+// N rings MPMC independientes ("shards"). Cada productor escribe en el suyo (uno por
+// vCPU, por CPU o por hash del pid), así que los productores de shards distintos no
+// compiten por el mismo 'tail' y escalan casi linealmente.
+// Cada consumidor tiene un shard "de casa": lo vacía primero y, cuando está vacío, roba
+// un lote de otro shard. El orden se conserva dentro de un shard, no entre shards.
+
+// Cómo elige un consumidor ocioso el shard al que robar.
+typedef enum {
+    RING_SET_STEAL_ROUND_ROBIN, // El siguiente shard tras el último robado (sin leer ocupación)
+    RING_SET_STEAL_OCCUPANCY,   // El shard con más eventos (lee head/tail de todos)
+} RingSetStealPolicy;
+
+typedef struct {
+    uint32_t shard_count;
+    RingSetStealPolicy steal_policy;
+    AtomicEventRingBuffer *shards[]; // Cada uno en su propia reserva alineada
+} RingSet;
+
+// Crea 'shards' rings de 'capacity' ranuras cada uno (misma regla que ring_buffer_create).
+// Retorna NULL si 'shards' es 0, la capacidad no es válida o falla alguna reserva.
+RingSet *ring_set_create(uint32_t shards, uint64_t capacity, RingSetStealPolicy steal_policy);
+void ring_set_destroy(RingSet *set);
+
+// Shard local para el productor: el de la CPU en la que corre ahora (sched_getcpu), o
+// el del hash de 'pid' (todos los eventos de un pid van al mismo shard y salen en orden).
+// Un productor con índice propio (p. ej. el número de vCPU) puede usarlo directamente.
+uint32_t ring_set_shard_for_cpu(const RingSet *set);
+uint32_t ring_set_shard_for_pid(const RingSet *set, uint32_t pid);
+
+// Encola en el shard 'shard' (módulo shard_count). Igual que enqueue_event/enqueue_events:
+// 0/-1 y número de eventos añadidos; un shard lleno no desborda a otro.
+int ring_set_enqueue(RingSet *set, uint32_t shard, const Event *event);
+size_t ring_set_enqueue_events(RingSet *set, uint32_t shard, const Event *events, size_t count);
+
+// Extrae del shard 'home' (módulo shard_count) y, si está vacío, roba hasta 'max'
+// eventos de otro shard según la política. Retorna 0/-1 y el número de eventos.
+int ring_set_dequeue(RingSet *set, uint32_t home, Event *event);
+size_t ring_set_dequeue_events(RingSet *set, uint32_t home, Event *events, size_t max);
+
+// Suma aproximada de la ocupación de todos los shards.
+uint64_t ring_set_size(RingSet *set);
+
+#endif // RING_SET_H
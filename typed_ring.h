@@ -0,0 +1,182 @@
+#ifndef TYPED_RING_H
+#define TYPED_RING_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "atomic_event_ring_buffer.h"
+
+// --- RINGS TIPADOS (solo cabecera) ---
+// DECLARE_RING(name, T, N) genera un ring MPMC para elementos de tipo T con N ranuras
+// (potencia de dos, >= 2, comprobado en compilación), con el mismo protocolo por ranura
+// que AtomicEventRingBuffer. Tamaño de elemento y capacidad son constantes: la copia es
+// una asignación de T que el compilador despliega, sin void* ni memcpy(size).
+// Genera, todas static inline:
+//     typedef ... name;                              // head, tail y ranuras, sin reservas
+//     void  name_init(name *r);                      // Para un ring estático o ya reservado
+//     name *name_create(void);                       // Reserva alineada + init; NULL si falla
+//     void  name_destroy(name *r);
+//     int    name_enqueue(name *r, const T *value);  // 0, o -1 si está lleno
+//     int    name_dequeue(name *r, T *value);        // 0, o -1 si está vacío
+//     size_t name_enqueue_batch(name *r, const T *values, size_t count);
+//     size_t name_dequeue_batch(name *r, T *values, size_t max);
+//     uint64_t name_size(name *r);                   // Ocupación aproximada
+// Uso: DECLARE_RING(MmioRing, MmioExit, 4096) en un .h o .c; cada unidad de traducción
+// que lo expanda tiene su propia copia (inline) de las funciones.
+
+#ifdef __x86_64__
+#define TYPED_RING_RELAX() __builtin_ia32_pause()
+#else
+#define TYPED_RING_RELAX() ((void)0)
+#endif
+
+#define DECLARE_RING(name, T, N)                                                                  \
+    _Static_assert((N) >= 2 && ((N) & ((N) - 1)) == 0, #name ": N debe ser potencia de dos >= 2"); \
+                                                                                                  \
+    typedef struct {                                                                              \
+        atomic_uint_least64_t sequence;                                                           \
+        T value;                                                                                  \
+    } name##_slot;                                                                                \
+                                                                                                  \
+    typedef struct {                                                                              \
+        ALIGNED(CACHE_LINE_SIZE) atomic_uint_least64_t head;                                      \
+        ALIGNED(CACHE_LINE_SIZE) atomic_uint_least64_t tail;                                      \
+        ALIGNED(CACHE_LINE_SIZE) name##_slot slots[N];                                            \
+    } name;                                                                                       \
+                                                                                                  \
+    static inline void name##_init(name *r) {                                                     \
+        atomic_store_explicit(&r->head, 0, memory_order_relaxed);                                 \
+        atomic_store_explicit(&r->tail, 0, memory_order_relaxed);                                 \
+        for (uint64_t i = 0; i < (N); i++) {                                                      \
+            atomic_store_explicit(&r->slots[i].sequence, i, memory_order_relaxed);                \
+        }                                                                                         \
+        atomic_thread_fence(memory_order_release);                                                \
+    }                                                                                             \
+                                                                                                  \
+    static inline name *name##_create(void) {                                                     \
+        size_t bytes = (sizeof(name) + CACHE_LINE_SIZE - 1) & ~(size_t)(CACHE_LINE_SIZE - 1);     \
+        name *r = aligned_alloc(CACHE_LINE_SIZE, bytes);                                          \
+        if (r != NULL) {                                                                          \
+            name##_init(r);                                                                       \
+        }                                                                                         \
+        return r;                                                                                 \
+    }                                                                                             \
+                                                                                                  \
+    static inline void name##_destroy(name *r) {                                                  \
+        free(r);                                                                                  \
+    }                                                                                             \
+                                                                                                  \
+    /* Reclama una posición lista para el lado 'lag' (0 productor, 1 consumidor). */              \
+    static inline name##_slot *name##_claim_slot_(atomic_uint_least64_t *counter, name *r,        \
+                                                  uint64_t lag, uint64_t *pos_out) {              \
+        uint64_t pos = atomic_load_explicit(counter, memory_order_relaxed);                       \
+        for (;;) {                                                                                \
+            name##_slot *slot = &r->slots[pos & ((N) - 1)];                                       \
+            uint64_t seq = atomic_load_explicit(&slot->sequence, memory_order_acquire);           \
+            int64_t diff = (int64_t)(seq - (pos + lag));                                          \
+            if (diff == 0) {                                                                      \
+                if (atomic_compare_exchange_weak_explicit(counter, &pos, pos + 1,                 \
+                                                          memory_order_relaxed,                   \
+                                                          memory_order_relaxed)) {                \
+                    *pos_out = pos;                                                               \
+                    return slot;                                                                  \
+                }                                                                                 \
+            } else if (diff < 0) {                                                                \
+                TYPED_RING_RELAX();                                                               \
+                return NULL;                                                                      \
+            } else {                                                                              \
+                pos = atomic_load_explicit(counter, memory_order_relaxed);                        \
+            }                                                                                     \
+        }                                                                                         \
+    }                                                                                             \
+                                                                                                  \
+    static inline int name##_enqueue(name *r, const T *value) {                                   \
+        uint64_t pos;                                                                             \
+        name##_slot *slot = name##_claim_slot_(&r->tail, r, 0, &pos);                             \
+        if (slot == NULL) {                                                                       \
+            return -1;                                                                            \
+        }                                                                                         \
+        slot->value = *value;                                                                     \
+        atomic_store_explicit(&slot->sequence, pos + 1, memory_order_release);                    \
+        return 0;                                                                                 \
+    }                                                                                             \
+                                                                                                  \
+    static inline int name##_dequeue(name *r, T *value) {                                         \
+        uint64_t pos;                                                                             \
+        name##_slot *slot = name##_claim_slot_(&r->head, r, 1, &pos);                             \
+        if (slot == NULL) {                                                                       \
+            return -1;                                                                            \
+        }                                                                                         \
+        *value = slot->value;                                                                     \
+        atomic_store_explicit(&slot->sequence, pos + (N), memory_order_release);                  \
+        return 0;                                                                                 \
+    }                                                                                             \
+                                                                                                  \
+    /* Reclama con un CAS el rango de ranuras consecutivas listas desde la actual. */             \
+    static inline size_t name##_claim_range_(atomic_uint_least64_t *counter, name *r,             \
+                                             uint64_t lag, size_t max, uint64_t *pos_out) {       \
+        if (max == 0) {                                                                           \
+            return 0;                                                                             \
+        }                                                                                         \
+        uint64_t pos = atomic_load_explicit(counter, memory_order_relaxed);                       \
+        for (;;) {                                                                                \
+            size_t n = 0;                                                                         \
+            while (n < max) {                                                                     \
+                uint64_t seq = atomic_load_explicit(&r->slots[(pos + n) & ((N) - 1)].sequence,    \
+                                                    memory_order_acquire);                        \
+                if (seq != pos + n + lag) {                                                       \
+                    break;                                                                        \
+                }                                                                                 \
+                n++;                                                                              \
+            }                                                                                     \
+            if (n == 0) {                                                                         \
+                uint64_t seq = atomic_load_explicit(&r->slots[pos & ((N) - 1)].sequence,          \
+                                                    memory_order_acquire);                        \
+                if ((int64_t)(seq - (pos + lag)) < 0) {                                           \
+                    TYPED_RING_RELAX();                                                           \
+                    return 0;                                                                     \
+                }                                                                                 \
+                pos = atomic_load_explicit(counter, memory_order_relaxed);                        \
+                continue;                                                                         \
+            }                                                                                     \
+            if (atomic_compare_exchange_weak_explicit(counter, &pos, pos + n,                     \
+                                                      memory_order_relaxed,                       \
+                                                      memory_order_relaxed)) {                    \
+                *pos_out = pos;                                                                   \
+                return n;                                                                         \
+            }                                                                                     \
+        }                                                                                         \
+    }                                                                                             \
+                                                                                                  \
+    static inline size_t name##_enqueue_batch(name *r, const T *values, size_t count) {           \
+        uint64_t pos;                                                                             \
+        size_t n = name##_claim_range_(&r->tail, r, 0, count, &pos);                              \
+        for (size_t i = 0; i < n; i++) {                                                          \
+            name##_slot *slot = &r->slots[(pos + i) & ((N) - 1)];                                 \
+            slot->value = values[i];                                                              \
+            atomic_store_explicit(&slot->sequence, pos + i + 1, memory_order_release);            \
+        }                                                                                         \
+        return n;                                                                                 \
+    }                                                                                             \
+                                                                                                  \
+    static inline size_t name##_dequeue_batch(name *r, T *values, size_t max) {                   \
+        uint64_t pos;                                                                             \
+        size_t n = name##_claim_range_(&r->head, r, 1, max, &pos);                                \
+        for (size_t i = 0; i < n; i++) {                                                          \
+            name##_slot *slot = &r->slots[(pos + i) & ((N) - 1)];                                 \
+            values[i] = slot->value;                                                              \
+            atomic_store_explicit(&slot->sequence, pos + i + (N), memory_order_release);          \
+        }                                                                                         \
+        return n;                                                                                 \
+    }                                                                                             \
+                                                                                                  \
+    static inline uint64_t name##_size(name *r) {                                                 \
+        uint64_t head = atomic_load_explicit(&r->head, memory_order_acquire);                     \
+        uint64_t tail = atomic_load_explicit(&r->tail, memory_order_acquire);                     \
+        uint64_t size = tail - head;                                                              \
+        return size > (N) ? (N) : size;                                                           \
+    }
+
+#endif // TYPED_RING_H